@@ -4,33 +4,143 @@
 
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
 #include <cassert>
+#include <cerrno>
+#include <charconv>
 #include <climits>
+#include <condition_variable>
 #include <cstddef>
 #include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
 #include <iostream>
+#include <iterator>
+#include <list>
+#include <mutex>
+#include <new>
+#include <numeric>
 #include <string>
 #include <thread>
+#include <type_traits>
 #include <vector>
 
+#if defined(_WIN32)
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #include <windows.h>
+    #include <io.h>
+#elif defined(__linux__)
+    #include <pthread.h>
+    #include <sched.h>
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+    #define MUSICAL_CALCULATOR_X86
+    #include <immintrin.h>
+    #if defined(_MSC_VER)
+        #include <intrin.h>
+    #endif
+#endif
+
+#if !defined(_WIN32)
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/socket.h>
+    #include <sys/stat.h>
+    #include <sys/un.h>
+    #include <unistd.h>
+#endif
+
 namespace musical_calculator {
 
     using count_t   = std::size_t;
     using index_t   = std::size_t;
 
     using note_t    = std::size_t;
+    using mask_t    = std::uint32_t;
+
+    class wide_count_t;
+
+    enum class storage_e : std::uint8_t;
+    enum class scale_kernel_e : std::uint8_t;
+    enum class format_e : std::uint8_t;
+    enum class simd_e : std::uint8_t;
+    enum class modulation_node_e : std::uint8_t;
+
+    struct chromatic_config_t;
 
     class mode_t;
     class scale_t;
 
+    class mode_generator_t;
+    class scale_generator_t;
+    class bracelet_generator_t;
+
+    template <typename generator_t, typename view_t>
+    class tier_stream_t;
+
+    class task_range_t;
+    class thread_pool_t;
+
+    template <typename result_t>
+    class task_results_t;
+
+    struct mode_chunk_t;
+    class step_tracker_t;
+
     template <count_t CHROMATIC_NOTE_COUNT_p>
     class mode_tier_t;
     template <count_t CHROMATIC_NOTE_COUNT_p>
     class scale_tier_t;
 
+    class scale_membership_t;
+    class bracelet_tier_t;
+    class scale_analytics_t;
+    class scale_index_t;
+    class scale_query_t;
+
     template <count_t CHROMATIC_NOTE_COUNT_p>
     class chromatic_t;
 
+    class chromatic_engine_t;
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    class baked_chromatic_t;
+
+    struct scale_location_t;
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    class scale_lookup_t;
+
+    struct snapshot_section_t;
+    struct snapshot_header_t;
+    class snapshot_t;
+
+    struct shard_header_t;
+    class shard_t;
+
+    struct write_chunk_t;
+    class writer_t;
+
+    struct pitch_set_answer_t;
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    class pitch_set_server_t;
+
+    struct modulation_config_t;
+    class modulation_paths_t;
+    class modulation_graph_t;
+
 }
 
 namespace musical_calculator {
@@ -40,6 +150,29 @@ namespace musical_calculator {
     // up the generation of all the patterns we're interested in, such as modes and scales.
     constexpr count_t MAX_CHROMATIC_NOTE_COUNT  = 24;
 
+    // A mask can hold one bit for every note of a chromatic up to this size.
+    constexpr count_t MAX_MASK_NOTE_COUNT       = sizeof(mask_t) * CHAR_BIT;
+
+    static_assert(MAX_CHROMATIC_NOTE_COUNT <= MAX_MASK_NOTE_COUNT);
+
+    // Tiers are split into chunks of at most this many modes, each of which is a separate task.
+    // This is small enough that even the largest tier keeps every core busy, and large enough
+    // that the cost of scheduling a chunk is lost in the cost of generating it.
+    constexpr count_t MAX_CHUNK_MODE_COUNT      = 16384;
+
+    // Work over the scales of a chromatic, such as measuring or writing them, is split into chunks of at most
+    // this many scales, each of which is a separate task. A scale costs about as much to measure or write
+    // as a mode does to classify, and so the chunks are the same size.
+    constexpr count_t MAX_CHUNK_SCALE_COUNT     = 16384;
+
+    // Chromatics with fewer modes than this are built on the calling thread alone,
+    // because waking the workers would cost more than the work itself.
+    constexpr count_t MIN_PARALLEL_MODE_COUNT   = 65536;
+
+    // Modes are classified as scales or not in blocks of this many at a time, which is
+    // a multiple of every vector width we use, and small enough to stay in the L1 cache.
+    constexpr count_t CLASSIFY_BLOCK_MODE_COUNT = 256;
+
     // if (mode_note_count > 1)
     //     return (chromatic_note_count - 1) choose (mode_note_count - 1)
     // else
@@ -157,6 +290,249 @@ namespace musical_calculator {
 
 }
 
+namespace musical_calculator {
+
+    /*
+        A wide count is an unsigned 128 bit integer that can be used in constant expressions.
+
+        It holds the counts of modes and scales for chromatics far larger than the ones
+        we can enumerate, many of which overflow count_t. Only the few operations the counts
+        need are supported, and multiplication and division are limited to 32 bit factors.
+    */
+    class wide_count_t
+    {
+    public:
+        std::uint64_t   high;
+        std::uint64_t   low;
+
+    public:
+        constexpr wide_count_t() noexcept;
+        constexpr wide_count_t(const std::uint64_t low) noexcept;
+        constexpr wide_count_t(const std::uint64_t high, const std::uint64_t low) noexcept;
+
+    public:
+        constexpr bool      Is_Count() const noexcept;
+        constexpr count_t   Count() const noexcept;
+        std::string         String() const;
+
+    public:
+        constexpr wide_count_t& operator +=(const wide_count_t& other) noexcept;
+        constexpr wide_count_t& operator -=(const wide_count_t& other) noexcept;
+        constexpr wide_count_t& operator *=(const std::uint32_t factor) noexcept;
+        constexpr wide_count_t& operator /=(const std::uint32_t divisor) noexcept;
+        constexpr std::uint32_t operator %(const std::uint32_t divisor) const noexcept;
+
+        friend constexpr wide_count_t   operator +(wide_count_t count, const wide_count_t& other) noexcept { return count += other; }
+        friend constexpr wide_count_t   operator -(wide_count_t count, const wide_count_t& other) noexcept { return count -= other; }
+        friend constexpr wide_count_t   operator *(wide_count_t count, const std::uint32_t factor) noexcept { return count *= factor; }
+        friend constexpr wide_count_t   operator /(wide_count_t count, const std::uint32_t divisor) noexcept { return count /= divisor; }
+        friend constexpr bool           operator ==(const wide_count_t& count, const wide_count_t& other) noexcept = default;
+        friend constexpr bool           operator <(const wide_count_t& count, const wide_count_t& other) noexcept
+        {
+            return count.high < other.high || (count.high == other.high && count.low < other.low);
+        }
+    };
+
+    // The counts below are exact for every chromatic up to this size. Past it, the tier in the middle
+    // of the chromatic has more modes than a wide count can hold.
+    constexpr count_t MAX_COUNTED_CHROMATIC_NOTE_COUNT = 128;
+
+    /*
+        These count the modes and scales of any chromatic up to MAX_COUNTED_CHROMATIC_NOTE_COUNT
+        without generating a single one of them.
+
+        A tier's modes are the ways to choose its other notes from the chromatic's other notes.
+        A tier's scales are the necklaces of the chromatic's length with as many beads as the tier has notes,
+        which are counted with the formula that follows from Burnside's lemma:
+            (1 / chromatic_note_count) * sum(totient(d) * ((chromatic_note_count / d) choose (scale_note_count / d)))
+        for every d that divides both chromatic_note_count and scale_note_count.
+    */
+    constexpr count_t       Count_Totient(count_t number) noexcept;
+    constexpr wide_count_t  Count_Combinations(const count_t count, const count_t choice_count) noexcept;
+    constexpr wide_count_t  Count_Tier_Modes(const count_t chromatic_note_count, const count_t mode_note_count) noexcept;
+    constexpr wide_count_t  Count_Modes(const count_t chromatic_note_count) noexcept;
+    constexpr wide_count_t  Count_Tier_Scales(const count_t chromatic_note_count, const count_t scale_note_count) noexcept;
+    constexpr wide_count_t  Count_Scales(const count_t chromatic_note_count) noexcept;
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A mask is the packed form of a mode. Bit (note - 1) is set for each note in the mode,
+        so (1 3 5) is 0b10101. Every mode starts with 1, and so bit 0 is always set.
+
+        A mask takes 4 bytes no matter how many notes the mode has, where the same mode
+        stored as notes takes sizeof(note_t) bytes per note.
+
+        Next_Mask steps from a mode to the one after it in its tier, in the same numerical order the
+        modes are generated in, and gives 0 after the last one.
+
+        Invert_Mask turns a mode upside down, so that each step up becomes the same step down, and so
+        (1 3 5 6 8 10 12) becomes (1 2 4 6 8 9 11). Scale_Mask gives the scale a mode belongs to, and
+        Bracelet_Mask gives whichever comes first of that scale and the scale of the mode's inversion.
+    */
+    constexpr mask_t    Note_Mask(const note_t note) noexcept;
+    constexpr mask_t    Notes_Mask(const note_t* const notes, const count_t note_count) noexcept;
+    constexpr count_t   Mask_Note_Count(const mask_t mask) noexcept;
+    constexpr note_t    Mask_Note(mask_t mask, const index_t index) noexcept;
+    constexpr void      Mask_Notes(mask_t mask, note_t* const results) noexcept;
+
+    constexpr mask_t    Chromatic_Mask(const count_t chromatic_note_count) noexcept;
+    constexpr mask_t    Revolve_Mask(const mask_t mask, const index_t distance, const count_t chromatic_note_count) noexcept;
+    constexpr bool      Mask_Precedes(const mask_t mask, const mask_t other_mask) noexcept;
+    constexpr bool      Is_Scale_Mask(const mask_t mask, const count_t chromatic_note_count) noexcept;
+    constexpr mask_t    Next_Mask(const mask_t mask, const count_t chromatic_note_count) noexcept;
+
+    constexpr mask_t    Invert_Mask(const mask_t mask, const count_t chromatic_note_count) noexcept;
+    constexpr mask_t    Scale_Mask(const mask_t mask, const count_t chromatic_note_count) noexcept;
+    constexpr mask_t    Bracelet_Mask(const mask_t mask, const count_t chromatic_note_count) noexcept;
+
+}
+
+namespace musical_calculator {
+
+    /*
+        Determines which instructions classify a batch of masks. The best one the processor supports
+        is found once at runtime, and every level gives the same results.
+
+        SCALAR works everywhere.
+        SSE2 classifies 4 masks at a time, and is on every x86-64 processor.
+        AVX2 classifies 8 masks at a time.
+    */
+    enum class simd_e : std::uint8_t
+    {
+        SCALAR,
+        SSE2,
+        AVX2,
+    };
+
+    /*
+        Classifying a batch of masks decides for each one whether it's a scale, like Is_Scale_Mask, but without branching.
+
+        Instead of revolving each mask only to its own notes, every mask is revolved by every distance from 1 to
+        chromatic_note_count - 1. A revolution to a distance without a note doesn't start with 1, and so it never
+        comes before the mask, which does. That makes the work the same for every mask in the batch, and so
+        a vector register can hold one mask per lane and revolve them all by the same distance at once.
+    */
+    simd_e  Simd_Level() noexcept;
+    void    Classify_Scale_Masks(const mask_t* const    masks,
+                                 const count_t          mask_count,
+                                 const count_t          chromatic_note_count,
+                                 std::uint8_t* const    is_scales,
+                                 const simd_e           simd = Simd_Level()) noexcept;
+
+}
+
+namespace musical_calculator {
+
+    /*
+        These convert between a mode and its index, in the same numerical order that modes are generated in,
+        without generating any of the modes around it.
+
+        The modes of a tier that come before a given mode are the ones that match it up to some note,
+        and have a smaller note there. For each place, those are counted with a sum of binomials,
+        which telescopes into just two lookups in the binomial tables, and so ranking a mode takes
+        a couple of lookups per note. Unranking walks the places the other way, skipping over as
+        many modes as each smaller note accounts for.
+
+        A mode's index in its tier is its rank. A mode's index in its chromatic counts every mode of
+        the smaller tiers first, which is how chromatic_t::Modes() is laid out. Either fits in 32 bits.
+    */
+    constexpr count_t   Choose(const count_t count, const count_t choice_count) noexcept;
+    constexpr index_t   Rank_Mask(const mask_t mask, const count_t chromatic_note_count) noexcept;
+    constexpr mask_t    Unrank_Mask(index_t mode_idx, const count_t mode_note_count, const count_t chromatic_note_count) noexcept;
+    constexpr index_t   Tier_First_Mode_Index(const count_t mode_note_count, const count_t chromatic_note_count) noexcept;
+    constexpr index_t   Mode_Index(const mask_t mask, const count_t chromatic_note_count) noexcept;
+    constexpr mask_t    Mode_Index_Mask(index_t mode_idx, const count_t chromatic_note_count) noexcept;
+
+}
+
+namespace musical_calculator {
+
+    /*
+        Determines how a chromatic stores its modes.
+
+        NOTES stores each mode as mode_note_count separate notes, which can be pointed to directly.
+        MASKS stores each mode as a single mask, which is decoded into notes only when asked.
+    */
+    enum class storage_e : std::uint8_t
+    {
+        NOTES,
+        MASKS,
+    };
+
+    /*
+        Determines how a scale tier decides whether a mode is the first occurence of its scale.
+
+        SCALE_MODES writes out every revolution of the mode's notes with Scale_Modes and compares them note by note.
+        ROTATIONS rotates the mode's mask to each of its notes and compares whole masks at once.
+        REVOLVING_DOOR generates each chunk's modes in revolving-door order, where each mode differs from the one
+        before it by a single note, and keeps a step_tracker_t up to date with that one note to decide each mode.
+        Each mode is still written to its place in numerical order. A tier whose modes already exist is decided
+        as ROTATIONS decides it, because there's no order to generate them in.
+
+        All give the same scales in the same order. SCALE_MODES and REVOLVING_DOOR are kept so that they can be compared.
+    */
+    enum class scale_kernel_e : std::uint8_t
+    {
+        SCALE_MODES,
+        ROTATIONS,
+        REVOLVING_DOOR,
+    };
+
+    /*
+        Determines how a writer_t writes out modes and scales.
+
+        TEXT writes each on its own line with its notes separated by spaces, e.g. "1 3 5".
+        CSV and TSV do the same with commas and tabs.
+        MASKS writes each as its mask, in 4 bytes of the machine's byte order, with nothing between them.
+    */
+    enum class format_e : std::uint8_t
+    {
+        TEXT,
+        CSV,
+        TSV,
+        MASKS,
+    };
+
+    /*
+        Determines what the nodes of a modulation graph are.
+
+        SCALES has one node for each scale of the chromatic, and so a path between them changes scale in any key.
+        MODES has one node for each mode of the chromatic, which all keep 1 as their root, and so a path between them
+        changes mode without changing key.
+    */
+    enum class modulation_node_e : std::uint8_t
+    {
+        SCALES,
+        MODES,
+    };
+
+    /*
+        The options a chromatic is constructed with.
+    */
+    struct chromatic_config_t
+    {
+        storage_e       storage         = storage_e::NOTES;
+        scale_kernel_e  scale_kernel    = scale_kernel_e::ROTATIONS;
+
+        // when false, the mode tiers are never generated and each scale tier is taken
+        // straight from a scale_generator_t, which costs only as much as the scales themselves.
+        bool            has_mode_tiers  = true;
+
+        // when true, each mode's scale and rotation and each scale's period are recorded as the scales are found,
+        // which costs 5 bytes per mode of the chromatic. see scale_membership_t.
+        bool            has_scale_memberships   = false;
+
+        // the pool the chromatic is built on. when null, the process-wide thread_pool_t::Default() is used.
+        // chromatics with fewer modes than min_parallel_mode_count are built serially no matter the pool.
+        thread_pool_t*  thread_pool             = nullptr;
+        count_t         min_parallel_mode_count = MIN_PARALLEL_MODE_COUNT;
+    };
+
+}
+
 namespace musical_calculator {
 
     /*
@@ -170,6 +546,9 @@ namespace musical_calculator {
 
         Notice that each modes starts with 1. This is because we only need to calcuate
         one key, the patterns of which all other keys share in common.
+
+        A mode is a view over either an array of notes or a mask. When it views a mask,
+        there is no array to point to, and so notes are decoded only when they are asked for.
     */
     class mode_t
     {
@@ -181,14 +560,18 @@ namespace musical_calculator {
     public:
         const note_t*   notes;
         count_t         note_count;
+        mask_t          mask;
 
     public:
         mode_t(const note_t* const notes, const count_t note_count) noexcept;
+        explicit mode_t(const mask_t mask) noexcept;
 
     public:
         count_t         Note_Count() noexcept;
         const note_t*   Notes() noexcept;
         note_t          Note(index_t index) noexcept;
+        void            Copy_Notes(note_t* const results) noexcept;
+        mask_t          Mask() noexcept;
 
         void            Print() noexcept;
 
@@ -217,6 +600,7 @@ namespace musical_calculator {
     {
     public:
         scale_t(const note_t* const notes, const count_t note_count) noexcept;
+        explicit scale_t(const mask_t mask) noexcept;
     };
 
 }
@@ -224,20 +608,29 @@ namespace musical_calculator {
 namespace musical_calculator {
 
     /*
-        A mode tier contains all the modes of the same note-count found in a chromatic scale.
+        A mode generator produces each mode in a tier one at a time, in the same numerical order as a mode tier,
+        while only ever holding the one mode it's on. It works for any chromatic a mask can hold.
+
+        It can start from any index in the tier, which is found with Unrank_Mask, and so a tier can be paged through
+        or split between workers without generating the modes that come before.
     */
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    class mode_tier_t
+    class mode_generator_t
     {
     public:
-        const note_t*   notes;
+        count_t chromatic_note_count;
+        count_t mode_note_count;
+        index_t first_mode_idx;
+        note_t  mode[MAX_MASK_NOTE_COUNT];
+        bool    is_started;
+        bool    is_done;
 
     public:
-        mode_tier_t() noexcept;
-        mode_tier_t(note_t* notes, const count_t mode_note_count) noexcept;
+        mode_generator_t(const count_t chromatic_note_count,
+                         const count_t mode_note_count,
+                         const index_t first_mode_idx = 0) noexcept;
 
     public:
-        void    Print_Modes(const count_t mode_count, const count_t mode_note_count) noexcept;
+        bool    Next(mask_t& result) noexcept;
     };
 
 }
@@ -245,27 +638,61 @@ namespace musical_calculator {
 namespace musical_calculator {
 
     /*
-        A scale tier contains all scales of the same note-count found in a chromatic scale.
+        A scale generator produces the first mode of each scale in a tier, without producing any of the other modes.
+
+        Instead of notes, it works with the steps between them. The mode (1 3 5) in a 12 note chromatic
+        has the steps (2 2 8), where the last step wraps around to the 1 of the next octave. Every revolution
+        of a mode revolves its steps, and the first mode of a scale is the one whose steps are numerically smallest.
+        Such a sequence of steps is known as a necklace, and the necklaces that add up to the chromatic's
+        note count are generated directly in numerical order by extending each one from the last, as in
+        the algorithm of Fredricksen, Kessler, and Maiorana. Because the order of the steps follows the order
+        of the notes, the scales come out in the same order that a scale tier finds them in its mode tier.
+
+        Prefixes that can no longer add up to the chromatic's note count are abandoned as soon as they're
+        found, and so the work done stays proportional to the number of scales, not the number of modes.
     */
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    class scale_tier_t
+    class scale_generator_t
     {
     public:
-        static void Scale_Modes(const note_t*   scale,
-                                const count_t   scale_note_count,
-                                note_t* const   results) noexcept;
+        count_t chromatic_note_count;
+        count_t scale_note_count;
+        count_t steps[MAX_MASK_NOTE_COUNT];
+        count_t step_sums[MAX_MASK_NOTE_COUNT];
+        count_t periods[MAX_MASK_NOTE_COUNT];
+        bool    is_started;
+        bool    is_done;
 
     public:
-        std::vector<const note_t*>  scales;
+        scale_generator_t(const count_t chromatic_note_count, const count_t scale_note_count) noexcept;
 
     public:
-        scale_tier_t() noexcept;
-        scale_tier_t(const mode_tier_t<CHROMATIC_NOTE_COUNT_p>& mode_tier,
-                     const count_t                              mode_count,
-                     const count_t                              mode_note_count);
+        bool    Next(mask_t& result) noexcept;
+    };
 
+}
+
+namespace musical_calculator {
+
+    /*
+        A bracelet generator produces the first scale of each set class in a tier, the bracelet that a bracelet tier
+        would name the class by, without producing any of the other scales or grouping them.
+
+        It takes the scales from a scale generator, in order, and keeps a scale only when it comes before the scale
+        of its inversion, or is that scale. Each is checked on its own, and so the work stays proportional to the
+        number of scales, and the bracelets come out in the same order that a bracelet tier keeps them in.
+        After each one, is_chiral says whether its class also holds the scale of its inversion.
+    */
+    class bracelet_generator_t
+    {
     public:
-        void    Print_Scales(const count_t scale_note_count) noexcept;
+        scale_generator_t   scale_generator;
+        bool                is_chiral;
+
+    public:
+        bracelet_generator_t(const count_t chromatic_note_count, const count_t scale_note_count) noexcept;
+
+    public:
+        bool    Next(mask_t& result) noexcept;
     };
 
 }
@@ -273,47 +700,1333 @@ namespace musical_calculator {
 namespace musical_calculator {
 
     /*
-        A chromatic is a set of a possible notes,
-        a set of all possible modes, or combination of the notes in one key,
-        and a set of all possible unique scales, or unique sets of modes which have members that derive each other.
+        A tier stream lazily yields the modes or scales of a chromatic, tier by tier, from the smallest tier to the largest.
 
-        For example, the standard Diatonic scale (C D E F G A B) is derived from a 12 note chromatic scale.
-        It can be represented with the numbers (1 3 5 6 8 10 12)
-        and it has seven modes: Ionian, Dorian, Phrygian, Lydian, Mixolydian, Aeolian, and Locrian,
-        all of which can be represented numerically and can derive one another.
+        Nothing is stored but the generator of the current tier, so it takes the same few hundred bytes for a chromatic
+        of 32 notes as it does for one of 3, and the first result is available immediately. It can be used in
+        a range-based for loop, or with Next directly:
+            for (scale_t scale : scale_stream_t(24)) { ... }
+    */
+    template <typename generator_t, typename view_t>
+    class tier_stream_t
+    {
+    public:
+        class iterator_t
+        {
+        public:
+            using value_type        = view_t;
+            using difference_type   = std::ptrdiff_t;
+            using iterator_concept  = std::input_iterator_tag;
 
-        One of the most interesting questions this program answers is, how many unique scales
-        can be derived from the chromatic? In the future I will be expanding this to answer even more
-        interesting questions that I had when I began developing my music theory about a decade ago.
-        Eventually it will be useful in generating patterns that can be learned to assist with naturally
-        good sounding ways to change key, mode, scale, and even chromatics.
+        public:
+            tier_stream_t*  stream;
+            mask_t          mask;
+            bool            is_done;
+
+        public:
+            iterator_t() noexcept;
+            explicit iterator_t(tier_stream_t& stream) noexcept;
+
+        public:
+            view_t      operator *() const noexcept;
+            iterator_t& operator ++() noexcept;
+            void        operator ++(int) noexcept;
+
+            friend bool operator ==(const iterator_t& iterator, std::default_sentinel_t) noexcept { return iterator.is_done; }
+        };
+
+    public:
+        count_t     chromatic_note_count;
+        count_t     note_count;
+        count_t     last_note_count;
+        generator_t generator;
+
+    public:
+        explicit tier_stream_t(const count_t chromatic_note_count) noexcept;
+        tier_stream_t(const count_t chromatic_note_count, const count_t tier_note_count) noexcept;
+
+    public:
+        bool                    Next(mask_t& result) noexcept;
+        count_t                 Note_Count() noexcept;
+
+        iterator_t              begin() noexcept;
+        std::default_sentinel_t end() noexcept;
+    };
+
+    using mode_stream_t     = tier_stream_t<mode_generator_t, mode_t>;
+    using scale_stream_t    = tier_stream_t<scale_generator_t, scale_t>;
+    using bracelet_stream_t = tier_stream_t<bracelet_generator_t, scale_t>;
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A task range holds the indices of the tasks that one worker has yet to run.
+
+        The worker takes tasks from the front of its own range, and when it runs out it steals the back half
+        of another worker's range. Both ends are packed into one atomic word, so that taking and stealing
+        are each a single compare and exchange, and no task can ever be taken twice.
     */
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    class chromatic_t
+    class alignas(64) task_range_t
     {
     public:
-        static_assert(CHROMATIC_NOTE_COUNT_p <= MAX_CHROMATIC_NOTE_COUNT);
+        std::atomic<std::uint64_t>  range;
 
     public:
-        note_t*                                 notes;
-        mode_tier_t<CHROMATIC_NOTE_COUNT_p>     mode_tiers[CHROMATIC_NOTE_COUNT_p];
-        scale_tier_t<CHROMATIC_NOTE_COUNT_p>    scale_tiers[CHROMATIC_NOTE_COUNT_p];
+        task_range_t() noexcept;
 
     public:
-        chromatic_t();
-        ~chromatic_t() noexcept;
+        void    Reset(const index_t begin, const index_t end) noexcept;
+        bool    Take(index_t& result) noexcept;
+        bool    Steal(task_range_t& victim, index_t& result) noexcept;
+    };
+
+    /*
+        A thread pool keeps its workers alive between jobs, so that building many small chromatics
+        doesn't mean creating and joining threads for each of them.
 
+        Run_Tasks runs every task in [0, task_count) exactly once, spread over the workers, which steal
+        work from each other when they run out. The calling thread is always one of the workers, and so
+        a pool with a worker_count of 1 has no threads at all and simply runs everything serially.
+        Jobs from different threads take turns, and a job started from inside a task runs serially
+        on that task's thread, which keeps a shared pool from ever waiting on itself.
+
+        When a task throws, the rest of the job's tasks are taken without being run, and once every worker
+        is done, Run_Tasks rethrows the first exception on the calling thread.
+
+        A task can also take the index of the worker running it, from 0 up to Worker_Count(). The tasks a worker
+        runs are run one after another, and so each worker can have a buffer of its own that its tasks share.
+
+        When is_pinned is set, each thread of the pool is bound to its own core.
+
+        Choose picks the pool for a job of some number of items: the serial pool it's given when there are too few
+        items to be worth waking the workers for, and otherwise the pool asked for, or Default() when none was.
+    */
+    class thread_pool_t
+    {
     public:
-        constexpr count_t       Chromatic_Note_Count() noexcept;
-        constexpr count_t       Mode_Count() noexcept;
-        count_t                 Scale_Count() noexcept;
+        static thread_pool_t&   Default();
+        static thread_pool_t&   Choose(const count_t            item_count,
+                                       thread_pool_t* const     thread_pool,
+                                       thread_pool_t&           serial_thread_pool,
+                                       const count_t            min_parallel_item_count = MIN_PARALLEL_MODE_COUNT);
 
-        std::vector<mode_t>     Modes();
-        std::vector<scale_t>    Scales();
+    public:
+        count_t                     worker_count;
+        bool                        is_pinned;
+        std::vector<task_range_t>   ranges;
+        std::vector<std::jthread>   threads;
+
+        std::mutex                  job_mutex;
+        std::mutex                  state_mutex;
+        std::condition_variable     start_condition;
+        std::condition_variable     stop_condition;
+        count_t                     job_generation;
+        count_t                     active_worker_count;
+        bool                        is_stopping;
+        void*                       job_context;
+        void                        (*Run_Job_Task)(void* job_context, const index_t task_idx, const index_t worker_idx);
+        std::atomic<bool>           is_job_failed;
+        std::exception_ptr          job_exception;
 
     public:
-        void    Print_Modes() noexcept;
-        void    Print_Scales() noexcept;
+        explicit thread_pool_t(const count_t worker_count = std::max(std::thread::hardware_concurrency(), 1u),
+                               const bool    is_pinned = false);
+        ~thread_pool_t() noexcept;
+
+        thread_pool_t(const thread_pool_t& other)               = delete;
+        thread_pool_t& operator =(const thread_pool_t& other)   = delete;
+
+    public:
+        count_t Worker_Count() noexcept;
+
+        template <typename Run_Task_f>
+        void    Run_Tasks(const count_t task_count, Run_Task_f&& Run_Task);
+
+    public:
+        template <typename Run_Task_f>
+        static void Run_Task_On_Worker(Run_Task_f& Run_Task, const index_t task_idx, const index_t worker_idx);
+
+        void    Work(const index_t worker_idx) noexcept;
+        void    Work_On_Job(const index_t worker_idx) noexcept;
+        void    Pin(std::jthread& thread, const index_t worker_idx) noexcept;
+    };
+
+    /*
+        Task results gather what each task of a job finds, when how much a task finds isn't known until it's done,
+        so that the results can be joined in the order of the tasks afterwards.
+
+        Each worker appends the results of its tasks to a buffer of its own, and each task keeps only where its results
+        begin in which buffer, and how many there are. The buffers only ever grow, and so a job allocates a few times
+        for each worker, however many tasks it has, and the workers never contend for the allocator over each task.
+    */
+    template <typename result_t>
+    class task_results_t
+    {
+    public:
+        struct span_t
+        {
+            index_t worker_idx;
+            index_t offset;
+            count_t count;
+        };
+
+    public:
+        std::vector<std::vector<result_t>>  worker_results;
+        std::vector<span_t>                 task_spans;
+
+    public:
+        task_results_t(const count_t worker_count, const count_t task_count, const count_t result_count = 0);
+
+    public:
+        void            Add(const index_t task_idx, const index_t worker_idx, const result_t* const results, const count_t result_count);
+
+        count_t         Result_Count(const index_t task_idx) noexcept;
+        const result_t* Results(const index_t task_idx) noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A mode chunk is a run of consecutive modes in a tier that all begin with the same notes.
+
+        Because modes are generated in numerical order, the modes that begin with a given prefix
+        are always next to each other, and how many there are is known from the binomial tables.
+        That lets each chunk be generated on its own, straight into its place in the tier.
+    */
+    struct mode_chunk_t
+    {
+        note_t  prefix[MAX_MASK_NOTE_COUNT];
+        count_t prefix_note_count;
+        index_t first_mode_idx;
+        count_t mode_count;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A step tracker follows one mode as its notes are added and removed, and keeps count of how many of
+        its steps there are of each size, from which it always knows the mode's smallest step.
+
+        That's what decides most modes: a scale always starts with its smallest step, and of its revolutions,
+        only those that start with the smallest step too could come before it. So a mode that doesn't start
+        with it is never a scale, and a mode that does is only compared with those few revolutions.
+
+        Adding or removing a note only ever splits one step in two or joins two steps into one,
+        and so the counts are kept up to date in a few word operations, whatever the size of the mode.
+    */
+    class step_tracker_t
+    {
+    public:
+        count_t         chromatic_note_count;
+        mask_t          mask;
+        count_t         smallest_step;
+        std::uint8_t    step_counts[MAX_CHROMATIC_NOTE_COUNT + 1];
+
+    public:
+        step_tracker_t(const mask_t mask, const count_t chromatic_note_count) noexcept;
+
+    public:
+        void    Add_Note(const index_t bit_idx) noexcept;
+        void    Remove_Note(const index_t bit_idx) noexcept;
+
+        bool    Is_Scale() noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A mode tier contains all the modes of the same note-count found in a chromatic scale.
+
+        Depending on the chromatic's storage, the modes are either kept in notes or in masks.
+        Only one of the two is ever set.
+
+        Generate_Revolving_Modes visits a chunk's modes in revolving-door order instead of numerical order,
+        and gives each to Write_Mode as a mask, along with the one note it lost and the one it gained.
+    */
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    class mode_tier_t
+    {
+    public:
+        template <typename Write_Mode_f>
+        static void Generate_Modes(const count_t mode_note_count, Write_Mode_f&& Write_Mode);
+        template <typename Write_Mode_f>
+        static void Generate_Modes(const note_t* const  prefix,
+                                   const count_t        prefix_note_count,
+                                   const count_t        mode_note_count,
+                                   Write_Mode_f&&       Write_Mode);
+
+        static std::vector<mode_chunk_t>    Mode_Chunks(const count_t mode_note_count, const count_t max_chunk_mode_count);
+        static mode_chunk_t                 Tier_Chunk(const count_t mode_note_count) noexcept;
+        static void                         Generate_Chunk(note_t* notes, const mode_chunk_t& chunk, const count_t mode_note_count);
+        static void                         Generate_Chunk(mask_t* masks, const mode_chunk_t& chunk, const count_t mode_note_count);
+
+        template <typename Write_Mode_f>
+        static void Generate_Revolving_Modes(const mode_chunk_t& chunk, const count_t mode_note_count, Write_Mode_f&& Write_Mode);
+
+    public:
+        const note_t*   notes;
+        const mask_t*   masks;
+
+    public:
+        mode_tier_t() noexcept;
+        mode_tier_t(note_t* notes, const count_t mode_note_count) noexcept;
+        mode_tier_t(mask_t* masks, const count_t mode_note_count) noexcept;
+
+    public:
+        mode_t  Mode(const index_t mode_idx, const count_t mode_note_count) noexcept;
+
+        void    Print_Modes(const count_t mode_count, const count_t mode_note_count) noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A scale tier contains all scales of the same note-count found in a chromatic scale.
+
+        Each scale is one 32 bit entry. When the mode tier stores notes, the entry is the index of the scale's first mode
+        in the mode tier, whose notes are viewed through mode_notes. Otherwise the entry is a copy of the first mode's mask,
+        which is how the scales are kept when there is no mode tier, and when the tier is loaded from a snapshot.
+
+        A chromatic keeps the entries of all its tiers in one arena that it allocates once at their exact size, and each tier
+        only views its own range of it, as does a tier loaded from a snapshot where the snapshot is mapped. A tier that is
+        made on its own owns its entries instead.
+    */
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    class scale_tier_t
+    {
+    public:
+        static void     Scale_Modes(const note_t*   scale,
+                                    const count_t   scale_note_count,
+                                    note_t* const   results) noexcept;
+
+        static count_t  Find_Scales(const mode_tier_t<CHROMATIC_NOTE_COUNT_p>&  mode_tier,
+                                    const index_t                               first_mode_idx,
+                                    const count_t                               mode_count,
+                                    const count_t                               mode_note_count,
+                                    const scale_kernel_e                        scale_kernel,
+                                    std::uint32_t* const                        results,
+                                    scale_membership_t* const                   membership = nullptr) noexcept;
+        static count_t  Find_Revolving_Scales(note_t* const             notes,
+                                              mask_t* const             masks,
+                                              const mode_chunk_t&       chunk,
+                                              const count_t             mode_note_count,
+                                              std::uint32_t* const      results,
+                                              scale_membership_t* const membership = nullptr) noexcept;
+
+    public:
+        std::vector<std::uint32_t>  entries;
+        const std::uint32_t*        viewed_entries;
+        count_t                     viewed_entry_count;
+        const note_t*               mode_notes;
+
+    public:
+        scale_tier_t() noexcept;
+        scale_tier_t(const std::uint32_t* viewed_entries, const count_t viewed_entry_count, const note_t* mode_notes = nullptr) noexcept;
+        scale_tier_t(const mode_tier_t<CHROMATIC_NOTE_COUNT_p>& mode_tier,
+                     const count_t                              mode_count,
+                     const count_t                              mode_note_count,
+                     const scale_kernel_e                       scale_kernel = scale_kernel_e::ROTATIONS);
+        explicit scale_tier_t(const count_t scale_note_count);
+
+    public:
+        count_t                 Scale_Count() noexcept;
+        const std::uint32_t*    Entries() noexcept;
+        scale_t                 Scale(const index_t scale_idx, const count_t scale_note_count) noexcept;
+        std::vector<mask_t>     Scale_Masks(const count_t scale_note_count);
+
+        void                    Print_Scales(const count_t scale_note_count) noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A scale membership says which scale of a tier each of the tier's modes belongs to, at which rotation,
+        and how many distinct modes each scale of the tier has, which is its period. Each is kept in its own array,
+        indexed by a mode's rank in its tier or by a scale's index in its tier, and so each is found in constant time.
+
+        The rotation is the index of the scale's note that becomes 1 in the mode, as in scale_location_t, and so
+        a scale is its own mode at rotation 0. The diatonic scale has a period of 7, but a scale that repeats itself
+        within the chromatic, such as the whole-tone scale, reaches each of its modes from more than one of its notes,
+        and then the period is smaller than its note count, and the rotation is the smallest one that reaches the mode.
+
+        The membership is recorded while the tier's scales are being found. Each scale is revolved through its notes
+        as soon as it is found, and its modes are marked with the rank of the scale, which is known right away even when
+        the scales are found in several chunks at once. Resolve then turns those ranks into scale indices in one pass
+        over the modes, which works because a scale always comes before every other one of its modes.
+    */
+    class scale_membership_t
+    {
+    public:
+        std::vector<std::uint32_t>  mode_scale_idxs;
+        std::vector<std::uint8_t>   mode_rotations;
+        std::vector<std::uint8_t>   scale_periods;
+
+    public:
+        scale_membership_t() noexcept;
+        explicit scale_membership_t(const count_t mode_count);
+
+    public:
+        void    Record_Scale(const mask_t scale_mask, const index_t scale_mode_idx, const count_t chromatic_note_count) noexcept;
+        void    Resolve(const count_t scale_count);
+
+    public:
+        count_t Mode_Count() noexcept;
+        count_t Scale_Count() noexcept;
+
+        index_t Mode_Scale_Index(const index_t mode_idx) noexcept;
+        index_t Mode_Rotation(const index_t mode_idx) noexcept;
+        count_t Scale_Period(const index_t scale_idx) noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A bracelet tier groups the scales of a tier into classes, where a scale and the scale of its inversion are the same class.
+        This is the set class of music theory, where pitch sets are equivalent under both transposition and inversion.
+
+        Each class is named by its first scale, its bracelet, and the classes are kept in the order of their bracelets.
+        A class is chiral when it holds two scales that are each other's mirror image, as (1 2 4) and (1 2 11) are in a
+        12 note chromatic, and achiral when its one scale inverts to one of its own modes, as the diatonic scale does.
+
+        The tier is built in one pass over the scales, in the order they were found in. A scale that comes before the scale
+        of its inversion, or is that scale, starts a new class, and any other scale joins the class its inversion's scale
+        already started, which is found by a binary search among the scales. The scales of a tier are always in order,
+        and so any scale tier can be grouped, whether it came from a chromatic_t, a chromatic_engine_t, or a snapshot.
+
+        A tier can also be enumerated from nothing but its note counts, with a bracelet_generator_t. It then holds only
+        the bracelets and whether each is chiral, and has no scales to look up the classes of.
+    */
+    class bracelet_tier_t
+    {
+    public:
+        count_t                     chromatic_note_count;
+        std::vector<mask_t>         bracelets;
+        std::vector<std::uint8_t>   is_chirals;
+        std::vector<std::uint32_t>  scale_bracelet_idxs;
+
+    public:
+        bracelet_tier_t() noexcept;
+        bracelet_tier_t(const mask_t* const scales, const count_t scale_count, const count_t chromatic_note_count);
+        bracelet_tier_t(const std::vector<mask_t>& scales, const count_t chromatic_note_count);
+        template <count_t CHROMATIC_NOTE_COUNT_p>
+        bracelet_tier_t(scale_tier_t<CHROMATIC_NOTE_COUNT_p>& scale_tier, const count_t scale_note_count);
+        bracelet_tier_t(const count_t chromatic_note_count, const count_t scale_note_count);
+
+    public:
+        count_t Scale_Count() noexcept;
+        count_t Bracelet_Count() noexcept;
+        count_t Chiral_Count() noexcept;
+
+        scale_t Bracelet(const index_t bracelet_idx) noexcept;
+        bool    Is_Chiral(const index_t bracelet_idx) noexcept;
+        index_t Scale_Bracelet_Index(const index_t scale_idx) noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        Scale analytics measure every scale of a chromatic at once, and keep each measure in its own column,
+        with one entry per scale in the same order as the chromatic's Scales(), so that a measure can be
+        scanned or filtered over every scale without touching any of the others.
+
+        The interval vector counts, for each interval class, the pairs of notes in the scale that are that far apart,
+        either way around the chromatic. Shifting the scale's mask by the interval and and-ing it with itself leaves
+        one bit for each pair, and so each count is one popcount, where the pairs of notes would otherwise each be
+        compared. The hemitonia of a scale are its semitones, the first column of the interval vector, and its
+        cohemitonia are the places where two semitones follow each other.
+
+        The steps of a scale are the distances from each of its notes to the next, and each step size has a column
+        that counts how many of the scale's steps are that size. The largest and smallest steps have columns too.
+
+        The interval vectors and step counts are kept one column after another, and all of the columns are filled
+        in chunks of scales that are spread over a thread pool.
+
+        The common tones of a scale with a reference pitch set are the most notes they share in any transposition
+        of the scale, and they are counted for a given reference in the same way, on demand.
+    */
+    class scale_analytics_t
+    {
+    public:
+        static count_t  Interval_Class_Count(const count_t chromatic_note_count) noexcept;
+
+    public:
+        count_t                     chromatic_note_count;
+        std::vector<mask_t>         scales;
+        std::vector<std::uint8_t>   interval_counts;
+        std::vector<std::uint8_t>   step_counts;
+        std::vector<std::uint8_t>   step_maxima;
+        std::vector<std::uint8_t>   step_minima;
+        std::vector<std::uint8_t>   cohemitonia;
+
+    public:
+        scale_analytics_t(const mask_t* const   scales,
+                          const count_t         scale_count,
+                          const count_t         chromatic_note_count,
+                          thread_pool_t* const  thread_pool = nullptr);
+        scale_analytics_t(std::vector<mask_t>&& scales,
+                          const count_t         chromatic_note_count,
+                          thread_pool_t* const  thread_pool = nullptr);
+        explicit scale_analytics_t(chromatic_engine_t& chromatic, thread_pool_t* const thread_pool = nullptr);
+        template <count_t CHROMATIC_NOTE_COUNT_p>
+        explicit scale_analytics_t(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic, thread_pool_t* const thread_pool = nullptr);
+
+    public:
+        void    Analyze(const index_t first_scale_idx, const count_t scale_count) noexcept;
+        void    Analyze(thread_pool_t* const thread_pool);
+
+    public:
+        count_t                 Scale_Count() noexcept;
+
+        const std::uint8_t*     Interval_Column(const count_t interval_class) noexcept;
+        const std::uint8_t*     Step_Column(const count_t step_size) noexcept;
+
+        count_t                 Interval_Count(const index_t scale_idx, const count_t interval_class) noexcept;
+        count_t                 Step_Count(const index_t scale_idx, const count_t step_size) noexcept;
+        count_t                 Step_Maximum(const index_t scale_idx) noexcept;
+        count_t                 Step_Minimum(const index_t scale_idx) noexcept;
+        count_t                 Hemitonia(const index_t scale_idx) noexcept;
+        count_t                 Cohemitonia(const index_t scale_idx) noexcept;
+
+        void                    Common_Tone_Counts(const mask_t             reference,
+                                                   std::uint8_t* const      results,
+                                                   thread_pool_t* const     thread_pool = nullptr);
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A scale index answers questions about which scales of a chromatic have some quality, by keeping one bit per scale
+        for each quality in a bitset, in the same order as the scale analytics it is built from.
+
+        There is a bitset for each interval class, with the scales that have at least one interval of that class,
+        and one for each step size, with the scales that have no step larger than it. The scales of each note count
+        are already a contiguous run, and so those need no bitset, only the offsets of each tier.
+
+        The index is built once, and then any number of queries can be made against it.
+    */
+    class scale_index_t
+    {
+    public:
+        static constexpr count_t    WORD_BIT_COUNT  = sizeof(std::uint64_t) * CHAR_BIT;
+
+    public:
+        count_t                     chromatic_note_count;
+        count_t                     word_count;
+        std::vector<mask_t>         scales;
+        std::vector<index_t>        tier_offsets;
+        std::vector<std::uint64_t>  interval_class_bitsets;
+        std::vector<std::uint64_t>  step_maximum_bitsets;
+
+    public:
+        explicit scale_index_t(scale_analytics_t& analytics);
+
+    public:
+        count_t                 Scale_Count() noexcept;
+        scale_t                 Scale(const index_t scale_idx) noexcept;
+
+        const std::uint64_t*    Interval_Class_Bitset(const count_t interval_class) noexcept;
+        const std::uint64_t*    Step_Maximum_Bitset(const count_t step_size) noexcept;
+
+        scale_query_t           Query();
+    };
+
+    /*
+        A scale query narrows down the scales of an index, one condition at a time, until only the scales that meet them all are left.
+
+        The query starts with every scale, and each condition is and-ed into it a whole word of scales at a time, and so is as cheap as
+        the bitsets are long. A pitch set is included by a scale when some transposition of the scale holds all of its notes. That is
+        narrowed down first by the interval classes of the pitch set, which any such scale must have, and only the scales left after
+        that are transposed and checked one by one.
+
+        The results are counted with popcount, or are yielded lazily, in order, as the indices of the scales that are left:
+            for (index_t scale_idx : index.Query().With_Note_Count(7).With_Max_Step(2)) { ... }
+        A condition added to a temporary query returns the query itself by value, and so a loop like this one owns
+        the query it iterates. A condition added to a named query returns a reference to it.
+    */
+    class scale_query_t
+    {
+    public:
+        class iterator_t
+        {
+        public:
+            using value_type        = index_t;
+            using difference_type   = std::ptrdiff_t;
+            using iterator_concept  = std::input_iterator_tag;
+
+        public:
+            const scale_query_t*    query;
+            index_t                 word_idx;
+            std::uint64_t           word;
+            index_t                 scale_idx;
+            bool                    is_done;
+
+        public:
+            iterator_t() noexcept;
+            explicit iterator_t(const scale_query_t& query) noexcept;
+
+        public:
+            index_t     operator *() const noexcept;
+            iterator_t& operator ++() noexcept;
+            void        operator ++(int) noexcept;
+
+            friend bool operator ==(const iterator_t& iterator, std::default_sentinel_t) noexcept { return iterator.is_done; }
+        };
+
+    public:
+        scale_index_t*              index;
+        std::vector<std::uint64_t>  words;
+
+    public:
+        explicit scale_query_t(scale_index_t& index);
+
+    public:
+        scale_query_t&  With_Note_Count(const count_t note_count) & noexcept;
+        scale_query_t&  With_Note_Counts(const count_t min_note_count, const count_t max_note_count) & noexcept;
+        scale_query_t&  With_Interval(const count_t interval) & noexcept;
+        scale_query_t&  Without_Interval(const count_t interval) & noexcept;
+        scale_query_t&  With_Max_Step(const count_t step_size) & noexcept;
+        scale_query_t&  With_Pitch_Set(const mask_t pitch_set_mask) & noexcept;
+
+        scale_query_t   With_Note_Count(const count_t note_count) && noexcept;
+        scale_query_t   With_Note_Counts(const count_t min_note_count, const count_t max_note_count) && noexcept;
+        scale_query_t   With_Interval(const count_t interval) && noexcept;
+        scale_query_t   Without_Interval(const count_t interval) && noexcept;
+        scale_query_t   With_Max_Step(const count_t step_size) && noexcept;
+        scale_query_t   With_Pitch_Set(const mask_t pitch_set_mask) && noexcept;
+
+    public:
+        count_t                 Count() const noexcept;
+        bool                    Has(const index_t scale_idx) const noexcept;
+
+        iterator_t              begin() const noexcept;
+        std::default_sentinel_t end() const noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A chromatic is a set of a possible notes,
+        a set of all possible modes, or combination of the notes in one key,
+        and a set of all possible unique scales, or unique sets of modes which have members that derive each other.
+
+        For example, the standard Diatonic scale (C D E F G A B) is derived from a 12 note chromatic scale.
+        It can be represented with the numbers (1 3 5 6 8 10 12)
+        and it has seven modes: Ionian, Dorian, Phrygian, Lydian, Mixolydian, Aeolian, and Locrian,
+        all of which can be represented numerically and can derive one another.
+
+        One of the most interesting questions this program answers is, how many unique scales
+        can be derived from the chromatic? In the future I will be expanding this to answer even more
+        interesting questions that I had when I began developing my music theory about a decade ago.
+        Eventually it will be useful in generating patterns that can be learned to assist with naturally
+        good sounding ways to change key, mode, scale, and even chromatics.
+    */
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    class chromatic_t
+    {
+    public:
+        static_assert(CHROMATIC_NOTE_COUNT_p <= MAX_CHROMATIC_NOTE_COUNT);
+
+    public:
+        storage_e                               storage;
+        scale_kernel_e                          scale_kernel;
+        bool                                    has_mode_tiers;
+        note_t*                                 notes;
+        mask_t*                                 masks;
+        std::uint32_t*                          scale_entries;
+        mode_tier_t<CHROMATIC_NOTE_COUNT_p>     mode_tiers[CHROMATIC_NOTE_COUNT_p];
+        scale_tier_t<CHROMATIC_NOTE_COUNT_p>    scale_tiers[CHROMATIC_NOTE_COUNT_p];
+        bool                                    has_scale_memberships;
+        scale_membership_t                      scale_memberships[CHROMATIC_NOTE_COUNT_p];
+
+    public:
+        chromatic_t(const chromatic_config_t& config = chromatic_config_t());
+        explicit chromatic_t(const snapshot_t& snapshot) noexcept;
+        ~chromatic_t() noexcept;
+
+        chromatic_t(const chromatic_t& other)               = delete;
+        chromatic_t& operator =(const chromatic_t& other)   = delete;
+
+    public:
+        constexpr count_t       Chromatic_Note_Count() noexcept;
+        constexpr count_t       Mode_Count() noexcept;
+        count_t                 Scale_Count() noexcept;
+
+        std::vector<mode_t>     Modes();
+        std::vector<scale_t>    Scales();
+        std::vector<mask_t>     Scale_Masks();
+
+        static mode_stream_t    Mode_Stream() noexcept;
+        static scale_stream_t   Scale_Stream() noexcept;
+
+        static index_t          Mode_Index(const mask_t mask) noexcept;
+        mode_t                  Mode(const index_t mode_idx) noexcept;
+
+    public:
+        void    Print_Modes() noexcept;
+        void    Print_Scales() noexcept;
+        void    Build(const chromatic_config_t& config, const index_t* const scale_tier_offsets);
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A chromatic engine is a chromatic whose note count is given when it's constructed instead of when it's compiled,
+        and so one compiled engine serves every chromatic up to MAX_CHROMATIC_NOTE_COUNT.
+
+        It always stores its modes and scales as masks, and always finds its scales by rotating masks,
+        and so the storage and scale kernel of its config are ignored. Each tier is split into chunks of
+        consecutive modes, the first of which is found by unranking, and the rest by stepping from one mask
+        to the next, so that each chunk is one pass of one loop that both generates modes and finds scales.
+
+        That loop is compiled once for any note count, and once more for each of the common chromatics in
+        SPECIALIZED_NOTE_COUNTS, where the note count is a constant and the compiler can fold it into the loop.
+
+        The modes and scales come out in the same order as chromatic_t's, and so they can be used interchangeably.
+        Like chromatic_t's, the scales of every tier are kept together, in one vector of exactly the size that the
+        counts of the tiers add up to, and each tier is a range of it.
+
+        An engine can also be built from the engine one note smaller, which is how a sweep over every chromatic size
+        should be done. The modes of each tier of N + 1 notes are the modes of the same tier of N notes, merged in
+        order with the modes of the tier below once note N + 1 is added to them, and so each chunk of a tier is merged
+        from the previous engine's mode tiers instead of stepped through mask by mask. None of the added modes is a scale,
+        save the one with every note, and so only the previous engine's modes need classifying. But those can't be
+        taken as they were, because a mode that isn't a scale of N notes can be one of N + 1: (1 3 6) is not a scale
+        of 7 notes, whose rotation (1 3 5) comes first, but it is a scale of 8.
+    */
+    class chromatic_engine_t
+    {
+    public:
+        static constexpr count_t    SPECIALIZED_NOTE_COUNTS[]   = { 12, 24 };
+
+        template <count_t FIXED_NOTE_COUNT_p>
+        static count_t  Generate_Chunk(const count_t        chromatic_note_count,
+                                       const count_t        mode_note_count,
+                                       const index_t        first_mode_idx,
+                                       const count_t        mode_count,
+                                       mask_t* const        modes,
+                                       mask_t* const        scales,
+                                       scale_membership_t*  membership = nullptr,
+                                       const chromatic_engine_t* previous = nullptr);
+        static count_t  Generate_Chunk(const count_t        chromatic_note_count,
+                                       const count_t        mode_note_count,
+                                       const index_t        first_mode_idx,
+                                       const count_t        mode_count,
+                                       mask_t* const        modes,
+                                       mask_t* const        scales,
+                                       scale_membership_t*  membership = nullptr,
+                                       const chromatic_engine_t* previous = nullptr);
+
+    public:
+        count_t                             chromatic_note_count;
+        bool                                has_mode_tiers;
+        std::vector<mask_t>                 modes;
+        std::vector<index_t>                mode_tier_offsets;
+        std::vector<mask_t>                 scales;
+        std::vector<index_t>                scale_tier_offsets;
+        bool                                has_scale_memberships;
+        std::vector<scale_membership_t>     scale_memberships;
+
+    public:
+        // when previous is given, it must be the chromatic one note smaller, and its mode tiers are merged into this one's.
+        // when either has no mode tiers there is nothing to merge, and previous is ignored.
+        explicit chromatic_engine_t(const count_t               chromatic_note_count,
+                                    const chromatic_config_t&   config = chromatic_config_t(),
+                                    const chromatic_engine_t*   previous = nullptr);
+
+    public:
+        count_t                 Chromatic_Note_Count() noexcept;
+        count_t                 Mode_Count() noexcept;
+        count_t                 Scale_Count() noexcept;
+        count_t                 Tier_Mode_Count(const count_t mode_note_count) noexcept;
+        count_t                 Tier_Scale_Count(const count_t scale_note_count) noexcept;
+
+        mode_t                  Mode(const index_t mode_idx) noexcept;
+        mode_t                  Tier_Mode(const index_t mode_idx, const count_t mode_note_count) noexcept;
+        scale_t                 Tier_Scale(const index_t scale_idx, const count_t scale_note_count) noexcept;
+
+        std::vector<mode_t>     Modes();
+        std::vector<scale_t>    Scales();
+        std::vector<mask_t>     Scale_Masks();
+
+    public:
+        void    Print_Modes() noexcept;
+        void    Print_Scales() noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    // Chromatics up to this size are small enough to be baked in whole when they're compiled.
+    constexpr count_t MAX_BAKED_CHROMATIC_NOTE_COUNT = 12;
+
+    /*
+        A baked chromatic is a chromatic that was computed when the program was compiled.
+
+        Its modes are stepped through with Next_Mask and its scales picked out with Is_Scale_Mask, the same as
+        the engine does at runtime, but in constant evaluation, and so its tables live in read-only static storage.
+        There is nothing to allocate or compute when one is used, and it costs nothing to construct.
+
+        The modes and scales are masks, in the same order as chromatic_t's, and each tier is a contiguous run of them.
+    */
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    class baked_chromatic_t
+    {
+    public:
+        static_assert(CHROMATIC_NOTE_COUNT_p > 0);
+        static_assert(CHROMATIC_NOTE_COUNT_p <= MAX_BAKED_CHROMATIC_NOTE_COUNT);
+
+        static constexpr count_t    MODE_COUNT  = CHROMATIC_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1];
+        static constexpr count_t    SCALE_COUNT = Count_Scales(CHROMATIC_NOTE_COUNT_p).Count();
+
+        static consteval std::array<mask_t, MODE_COUNT>                     Bake_Modes() noexcept;
+        static consteval std::array<mask_t, SCALE_COUNT>                    Bake_Scales() noexcept;
+        static consteval std::array<index_t, CHROMATIC_NOTE_COUNT_p + 1>    Bake_Scale_Tier_Offsets() noexcept;
+
+        static constexpr std::array<mask_t, MODE_COUNT>                     MODES               = Bake_Modes();
+        static constexpr std::array<mask_t, SCALE_COUNT>                    SCALES              = Bake_Scales();
+        static constexpr std::array<index_t, CHROMATIC_NOTE_COUNT_p + 1>    SCALE_TIER_OFFSETS  = Bake_Scale_Tier_Offsets();
+
+    public:
+        static constexpr count_t        Chromatic_Note_Count() noexcept;
+        static constexpr count_t        Mode_Count() noexcept;
+        static constexpr count_t        Scale_Count() noexcept;
+        static constexpr count_t        Tier_Mode_Count(const count_t mode_note_count) noexcept;
+        static constexpr count_t        Tier_Scale_Count(const count_t scale_note_count) noexcept;
+        static constexpr const mask_t*  Mode_Tier(const count_t mode_note_count) noexcept;
+        static constexpr const mask_t*  Scale_Tier(const count_t scale_note_count) noexcept;
+
+        static std::vector<mode_t>      Modes();
+        static std::vector<scale_t>     Scales();
+
+    public:
+        static void Print_Modes() noexcept;
+        static void Print_Scales() noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A scale location says which scale a mode belongs to, and where in that scale the mode starts.
+
+        The scale index is the scale's place in chromatic_t::Scales(), and the rotation is the index of the
+        scale's note that becomes 1 in the mode. A scale that repeats itself within the chromatic reaches the
+        same mode from more than one of its notes, and then the rotation is the smallest of them.
+    */
+    struct scale_location_t
+    {
+        index_t scale_idx;
+        count_t scale_note_count;
+        index_t rotation;
+    };
+
+    /*
+        A scale lookup answers which scale a mode belongs to in constant time, with one entry for every mode of the chromatic.
+
+        Every mode has bit 0 set, and so a mode's mask shifted down by one is its entry, which makes 2^(N - 1) entries,
+        some 8 million of them for the largest chromatic. Each entry packs a scale location into 32 bits, and is filled in when the
+        lookup is built by revolving each scale of the chromatic through all of its notes, which takes one pass over the scales.
+
+        A pitch set doesn't have to start on 1, and so it's first transposed down to its lowest note, which makes it a mode.
+    */
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    class scale_lookup_t
+    {
+    public:
+        static_assert(CHROMATIC_NOTE_COUNT_p <= MAX_CHROMATIC_NOTE_COUNT);
+
+        static constexpr count_t    SCALE_IDX_BIT_COUNT = 20;
+        static constexpr count_t    NOTE_COUNT_BIT_COUNT = 5;
+        static constexpr count_t    ROTATION_BIT_COUNT = 5;
+
+        static_assert(MAX_CHROMATIC_NOTE_COUNT <= (1ull << NOTE_COUNT_BIT_COUNT));
+        static_assert(MAX_CHROMATIC_NOTE_COUNT <= (1ull << ROTATION_BIT_COUNT));
+
+        static std::uint32_t    Pack_Location(const scale_location_t& location) noexcept;
+        static scale_location_t Unpack_Location(const std::uint32_t entry) noexcept;
+
+        static mask_t           Pitch_Set_Mode(const mask_t pitch_set_mask, index_t* const transposition = nullptr) noexcept;
+
+    public:
+        std::vector<std::uint32_t>  entries;
+        const std::uint32_t*        mapped_entries;
+
+    public:
+        explicit scale_lookup_t(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic);
+        explicit scale_lookup_t(const snapshot_t& snapshot) noexcept;
+
+    public:
+        count_t                 Entry_Count() noexcept;
+        const std::uint32_t*    Entries() noexcept;
+
+        scale_location_t    Find(const mask_t mode_mask) noexcept;
+        void                Find(const mask_t* const mode_masks,
+                                 const count_t mode_count,
+                                 scale_location_t* const results) noexcept;
+
+        scale_location_t    Find_Pitch_Set(const mask_t pitch_set_mask, index_t* const transposition = nullptr) noexcept;
+        void                Find_Pitch_Sets(const mask_t* const pitch_set_masks,
+                                            const count_t pitch_set_count,
+                                            scale_location_t* const results) noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A snapshot is a file holding everything a chromatic computed, so that it can be opened in another
+        process without computing any of it again.
+
+        The file starts with a header saying which chromatic it holds and where each of its sections are.
+        Each mode tier and scale tier is a section of masks, in the same order they are generated in,
+        and a scale lookup, when there is one, is a section of its packed entries. Every section starts
+        on a page boundary, and so the whole file can be mapped and the sections used right where they are.
+        Opening a snapshot only reads the header, and each page of a section is read when it's first touched.
+        Several processes mapping the same file share the one copy of it that's cached.
+
+        The header has its own checksum, which is checked on opening. The sections have another, which takes
+        reading every page to check, and so it's only checked when asked for with Verify().
+
+        The numbers are stored in the byte order of the machine that wrote them, and a snapshot written
+        on a machine of the other order won't open.
+    */
+    struct snapshot_section_t
+    {
+        std::uint64_t   offset;
+        std::uint64_t   count;
+    };
+
+    struct snapshot_header_t
+    {
+        char                magic[8];
+        std::uint32_t       version;
+        std::uint32_t       byte_order;
+        std::uint32_t       chromatic_note_count;
+        std::uint32_t       flags;
+        std::uint64_t       file_size;
+        std::uint64_t       section_checksum;
+        snapshot_section_t  mode_tiers[MAX_CHROMATIC_NOTE_COUNT];
+        snapshot_section_t  scale_tiers[MAX_CHROMATIC_NOTE_COUNT];
+        snapshot_section_t  scale_lookup;
+        std::uint64_t       header_checksum;
+    };
+
+    class snapshot_t
+    {
+    public:
+        static constexpr char           MAGIC[8]            = { 'M', 'U', 'S', 'C', 'A', 'L', 'C', '\0' };
+        static constexpr std::uint32_t  VERSION             = 1;
+        static constexpr std::uint32_t  BYTE_ORDER_MARK     = 0x01020304;
+        static constexpr std::uint64_t  SECTION_ALIGNMENT   = 4096;
+
+        static constexpr std::uint32_t  HAS_MODE_TIERS      = 1 << 0;
+        static constexpr std::uint32_t  HAS_SCALE_LOOKUP    = 1 << 1;
+
+        static std::uint64_t    Checksum(const void* data, const std::uint64_t size, std::uint64_t checksum = 0xCBF29CE484222325) noexcept;
+
+        template <count_t CHROMATIC_NOTE_COUNT_p>
+        static bool             Write(const char* path,
+                                      chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic,
+                                      scale_lookup_t<CHROMATIC_NOTE_COUNT_p>* scale_lookup = nullptr) noexcept;
+
+    public:
+        const std::uint8_t* data;
+        std::uint64_t       size;
+#if defined(_WIN32)
+        HANDLE              file;
+        HANDLE              mapping;
+#endif
+
+    public:
+        snapshot_t() noexcept;
+        explicit snapshot_t(const char* path) noexcept;
+        snapshot_t(const snapshot_t& other)             = delete;
+        snapshot_t& operator =(const snapshot_t& other) = delete;
+        ~snapshot_t() noexcept;
+
+    public:
+        bool                        Open(const char* path) noexcept;
+        void                        Close() noexcept;
+        bool                        Verify() const noexcept;
+
+        bool                        Is_Open() const noexcept;
+        const snapshot_header_t&    Header() const noexcept;
+        count_t                     Chromatic_Note_Count() const noexcept;
+        bool                        Has_Mode_Tiers() const noexcept;
+        bool                        Has_Scale_Lookup() const noexcept;
+
+        const mask_t*               Mode_Tier(const index_t tier_idx, count_t* const mode_count = nullptr) const noexcept;
+        const mask_t*               Scale_Tier(const index_t tier_idx, count_t* const scale_count = nullptr) const noexcept;
+        const std::uint32_t*        Scale_Lookup(count_t* const entry_count = nullptr) const noexcept;
+
+    public:
+        bool                        Map(const char* path) noexcept;
+        const void*                 Section(const snapshot_section_t& section, const count_t item_size) const noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A shard is a slice of a chromatic, a range of its modes by their index in the whole chromatic,
+        from which only the scales are kept. Shards can be computed in separate processes or on separate machines,
+        written to files, and merged back together, with nothing shared between them but the files.
+
+        Shard_First_Mode_Index splits the modes of a chromatic evenly between some number of shards, and so
+        shard i of k is every mode from Shard_First_Mode_Index(i) up to Shard_First_Mode_Index(i + 1). The range
+        can cross from one tier into the next, and each tier it covers is generated and classified a chunk at a time,
+        the same as chromatic_engine_t does it.
+
+        Two shards of the same chromatic merge when one's range ends where the other's begins, and the scales of each
+        tier are joined in order. Once every mode is covered, its scales are the same as those of the whole chromatic.
+
+        The file is a shard_header_t, which has a checksum of its own and one of the scales that come after it,
+        and then the scales of each tier in turn, as masks. Like a snapshot, it's in the byte order of the machine
+        that wrote it.
+    */
+    struct shard_header_t
+    {
+        char            magic[8];
+        std::uint32_t   version;
+        std::uint32_t   byte_order;
+        std::uint64_t   chromatic_note_count;
+        std::uint64_t   first_mode_idx;
+        std::uint64_t   mode_count;
+        std::uint64_t   scale_counts[MAX_CHROMATIC_NOTE_COUNT];
+        std::uint64_t   scale_checksum;
+        std::uint64_t   header_checksum;
+    };
+
+    class shard_t
+    {
+    public:
+        static constexpr char           MAGIC[8]        = { 'M', 'U', 'S', 'H', 'A', 'R', 'D', '\0' };
+        static constexpr std::uint32_t  VERSION         = 1;
+
+        static index_t  Shard_First_Mode_Index(const count_t chromatic_note_count,
+                                               const index_t shard_idx,
+                                               const count_t shard_count) noexcept;
+
+    public:
+        count_t                             chromatic_note_count;
+        index_t                             first_mode_idx;
+        count_t                             mode_count;
+        std::vector<std::vector<mask_t>>    scale_tiers;
+
+    public:
+        shard_t() noexcept;
+        shard_t(const count_t           chromatic_note_count,
+                const index_t           first_mode_idx,
+                const count_t           mode_count,
+                thread_pool_t* const    thread_pool = nullptr);
+
+    public:
+        bool        Read(const char* path);
+        bool        Write(const char* path) const noexcept;
+        bool        Merge(const shard_t& other);
+
+        bool        Is_Complete() const noexcept;
+        count_t     Chromatic_Note_Count() const noexcept;
+        index_t     First_Mode_Index() const noexcept;
+        count_t     Mode_Count() const noexcept;
+        count_t     Scale_Count() const noexcept;
+        count_t     Tier_Scale_Count(const count_t scale_note_count) const noexcept;
+        scale_t     Tier_Scale(const index_t scale_idx, const count_t scale_note_count) const noexcept;
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A write chunk is a run of consecutive modes or scales in one tier, which is formatted as one task.
+    */
+    struct write_chunk_t
+    {
+        index_t tier_idx;
+        index_t first_idx;
+        count_t count;
+    };
+
+    /*
+        A writer formats modes and scales into a large buffer and writes the buffer out only when it fills,
+        so that writing millions of them costs a handful of writes instead of one per line.
+
+        It writes to either a FILE, which can be a file, a pipe, or stdout, or to a std::ostream.
+
+        Writing a whole chromatic splits its tiers into chunks, and the chunks of a window are formatted
+        in parallel into buffers of their own. The buffers are then written in order, and so the output
+        is the same as if it were written serially. The buffers are reused for each window, and so the
+        memory used stays the same however large the chromatic is.
+    */
+    class writer_t
+    {
+    public:
+        static constexpr count_t    BUFFER_SIZE                 = 1 << 20;
+        static constexpr count_t    MAX_FORMATTED_MODE_SIZE     = MAX_MASK_NOTE_COUNT * 3;
+        static constexpr count_t    WINDOW_CHUNKS_PER_WORKER    = 4;
+
+        static char*    Format_Notes(char* cursor, const note_t* const notes, const count_t note_count, const format_e format) noexcept;
+        static char*    Format_Mask(char* cursor, const mask_t mask, const format_e format) noexcept;
+        static char*    Format_Mode(char* cursor, const mode_t& mode, const format_e format) noexcept;
+
+    public:
+        format_e            format;
+        std::FILE*          file;
+        std::ostream*       stream;
+        std::vector<char>   buffer;
+        count_t             buffer_size;
+        bool                is_good;
+
+    public:
+        explicit writer_t(std::FILE* file, const format_e format = format_e::TEXT);
+        explicit writer_t(std::ostream& stream, const format_e format = format_e::TEXT);
+        writer_t(const writer_t& other)             = delete;
+        writer_t& operator =(const writer_t& other) = delete;
+        ~writer_t() noexcept;
+
+    public:
+        bool    Is_Good() noexcept;
+        bool    Flush() noexcept;
+
+        void    Write_Bytes(const char* const bytes, const count_t byte_count) noexcept;
+        void    Write_Mode(const mode_t& mode) noexcept;
+
+        template <count_t CHROMATIC_NOTE_COUNT_p>
+        void    Write_Modes(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic, thread_pool_t* thread_pool = nullptr);
+        template <count_t CHROMATIC_NOTE_COUNT_p>
+        void    Write_Scales(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic, thread_pool_t* thread_pool = nullptr);
+        void    Write_Modes(chromatic_engine_t& engine, thread_pool_t* thread_pool = nullptr);
+        void    Write_Scales(chromatic_engine_t& engine, thread_pool_t* thread_pool = nullptr);
+
+        template <typename mode_at_t>
+        void    Write_Chunks(const std::vector<write_chunk_t>& chunks, thread_pool_t& thread_pool, mode_at_t&& Mode_At);
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        A pitch set answer says which scale a pitch set is a mode of, once it's transposed down to start on 1.
+
+        The scale is given both as its mask and as its index in chromatic_t::Scales(), along with its note count,
+        which is its tier, and the rotation of the scale that gives the mode, as a scale_location_t has it.
+        The mode index is the mode's index in the whole chromatic, and the transposition is how far it was moved down.
+        A pitch set that is empty or has notes outside the chromatic isn't valid, and the rest of its answer is 0.
+
+        It's 16 bytes with no padding, which is exactly how it's written when answering in masks.
+    */
+    struct pitch_set_answer_t
+    {
+        mask_t          scale_mask;
+        std::uint32_t   scale_idx;
+        std::uint32_t   mode_idx;
+        std::uint8_t    scale_note_count;
+        std::uint8_t    rotation;
+        std::uint8_t    transposition;
+        std::uint8_t    is_valid;
+    };
+
+    static_assert(sizeof(pitch_set_answer_t) == 16);
+
+    /*
+        A pitch set server answers a stream of pitch sets for as long as the stream lasts, using a chromatic and a
+        scale lookup that are built or loaded once, before it starts. It reads from a file descriptor, such as stdin,
+        or from every connection made to a Unix socket.
+
+        The queries are read a large buffer at a time, and everything that a read brings in is parsed, answered, and
+        written as one batch, up to BATCH_QUERY_COUNT queries at a time. A client that waits for each answer before
+        sending the next query still gets it straight away, and one that streams gets them a batch at a time.
+
+        In masks, each query is a pitch set's mask in 4 bytes and each answer is a pitch_set_answer_t. In any other
+        format, each query is a line of notes from 1 up, e.g. "1 5 8", separated by spaces, commas, or tabs, and each
+        answer is a line with the scale's notes, its note count, the rotation, the mode index, and the transposition,
+        separated by tabs, or "invalid". A line too long to fit the buffer is answered as invalid.
+
+        Serve_Socket serves each connection on its own thread, so that any number of clients can be connected at once.
+        It replaces a socket that is left at the path, but fails if anything else is there. It only returns when the socket
+        can't be made or stops accepting connections, and then returns false with errno saying why.
+        There are no Unix sockets on Windows, where it always fails.
+    */
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    class pitch_set_server_t
+    {
+    public:
+        static constexpr count_t    READ_BUFFER_SIZE            = 1 << 20;
+        static constexpr count_t    BATCH_QUERY_COUNT           = 1 << 16;
+        static constexpr count_t    MAX_FORMATTED_ANSWER_SIZE   = writer_t::MAX_FORMATTED_MODE_SIZE + 32;
+
+        static mask_t   Parse_Pitch_Set(const char* cursor, const char* const end) noexcept;
+        static char*    Format_Answer(char* cursor, const pitch_set_answer_t& answer, const format_e format) noexcept;
+
+    public:
+        scale_lookup_t<CHROMATIC_NOTE_COUNT_p>& scale_lookup;
+        format_e                                format;
+        std::vector<mask_t>                     scale_masks;
+
+    public:
+        pitch_set_server_t(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic,
+                           scale_lookup_t<CHROMATIC_NOTE_COUNT_p>& scale_lookup,
+                           const format_e format = format_e::TEXT);
+
+    public:
+        void    Answer(const mask_t* const pitch_sets, const count_t pitch_set_count, pitch_set_answer_t* const answers) noexcept;
+        bool    Serve(const int input_fd, const int output_fd);
+        bool    Serve_Socket(const char* path);
+    };
+
+}
+
+namespace musical_calculator {
+
+    /*
+        The options a modulation graph is constructed with.
+    */
+    struct modulation_config_t
+    {
+        // which ways of changing one note make an edge. a note is moved by one step up or down the chromatic,
+        // to a place that is free. without both added and removed notes, the edges only go one way.
+        bool            has_added_notes     = true;
+        bool            has_removed_notes   = true;
+        bool            has_moved_notes     = true;
+
+        // the pool the graph is built on. when null, the process-wide thread_pool_t::Default() is used.
+        thread_pool_t*  thread_pool         = nullptr;
+    };
+
+    /*
+        Modulation paths are what a search of a modulation graph finds: how far each node is from the source,
+        and the node each was first reached from, which can be followed back to the source to give a shortest path.
+
+        A search that is given a target stops after the step that reaches it, and so only the nodes
+        that are no farther from the source than the target are sure to have been reached.
+    */
+    class modulation_paths_t
+    {
+    public:
+        static constexpr std::uint32_t  NO_NODE             = ~std::uint32_t(0);
+        static constexpr std::uint8_t   UNREACHED_DISTANCE  = ~std::uint8_t(0);
+
+    public:
+        index_t                     source_idx;
+        std::vector<std::uint8_t>   distances;
+        std::vector<std::uint32_t>  parents;
+
+    public:
+        modulation_paths_t(const index_t source_idx, const count_t node_count);
+
+    public:
+        count_t                 Reached_Count() noexcept;
+
+        bool                    Is_Reached(const index_t node_idx) noexcept;
+        count_t                 Distance(const index_t node_idx) noexcept;
+        std::vector<index_t>    Path(const index_t target_idx);
+    };
+
+    /*
+        A modulation graph connects the scales or the modes of a chromatic that differ by one note, so that
+        the ways of changing from one to another, one note at a time, can be searched.
+
+        A node's neighbours are never found by comparing it with the other nodes. Each is one or two bit flips
+        of the node's mask, and is put back in the form of a node and looked up: a mode is ranked with Mode_Index,
+        and a pitch set is transposed down to a mode, turned into its scale with Scale_Mask, and found among the
+        scales of its tier with a binary search. A node has at most three neighbours for each note of the chromatic.
+
+        A graph of scales can be built from any list of them, which is put in the order a chromatic gives them in,
+        without repeats. A change to a scale that isn't in the list leads nowhere, and so it has no edge, and
+        Node_Index gives modulation_paths_t::NO_NODE for it. A chromatic's own scales always have every edge.
+
+        The edges are kept in compressed sparse rows, where the neighbours of every node follow one another in
+        one array, in order, and each node's run of them starts at its offset. The offsets and the edges are both
+        filled in parallel, in chunks of nodes: once with each node's neighbour count, which is summed into the
+        offsets, and again with the neighbours themselves, each written straight into its place.
+
+        A search is breadth first, and goes one step farther from the source at a time. The nodes reached in one
+        step are the frontier of the next, which is split into chunks that are spread over a thread pool, and a node
+        is claimed by whichever chunk is first to swap in its parent. Each chunk collects the nodes it claims, and
+        those make up the next frontier.
+
+        The scales of a 12 note chromatic make a graph of 351 nodes, and the modes of a 24 note one, some 8 million
+        nodes and 285 million edges, which take about 1.2GB.
+    */
+    class modulation_graph_t
+    {
+    public:
+        static constexpr count_t    MAX_NEIGHBOUR_COUNT     = MAX_CHROMATIC_NOTE_COUNT * 3;
+        static constexpr count_t    BUILD_CHUNK_NODE_COUNT  = 16384;
+        static constexpr count_t    SEARCH_CHUNK_NODE_COUNT = 4096;
+
+    public:
+        count_t                     chromatic_note_count;
+        modulation_node_e           node;
+        modulation_config_t         config;
+        std::vector<mask_t>         scales;
+        std::vector<index_t>        tier_offsets;
+        std::vector<std::uint64_t>  edge_offsets;
+        std::vector<std::uint32_t>  edges;
+
+    public:
+        modulation_graph_t(const mask_t* const          scales,
+                           const count_t                scale_count,
+                           const count_t                chromatic_note_count,
+                           const modulation_config_t&   config = modulation_config_t());
+        modulation_graph_t(std::vector<mask_t>&&        scales,
+                           const count_t                chromatic_note_count,
+                           const modulation_config_t&   config = modulation_config_t());
+        explicit modulation_graph_t(chromatic_engine_t& chromatic, const modulation_config_t& config = modulation_config_t());
+        template <count_t CHROMATIC_NOTE_COUNT_p>
+        explicit modulation_graph_t(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic, const modulation_config_t& config = modulation_config_t());
+        explicit modulation_graph_t(const count_t chromatic_note_count, const modulation_config_t& config = modulation_config_t());
+
+    public:
+        count_t Modulate(const mask_t mask, mask_t* const results) noexcept;
+        count_t Find_Neighbours(const mask_t mask, std::uint32_t* const results) noexcept;
+        void    Build_Chunk(const index_t chunk_idx, const bool is_counting) noexcept;
+        void    Build();
+
+    public:
+        count_t                 Node_Count() noexcept;
+        count_t                 Edge_Count() noexcept;
+
+        mask_t                  Node_Mask(const index_t node_idx) noexcept;
+        index_t                 Node_Index(const mask_t pitch_set_mask) noexcept;
+
+        count_t                 Neighbour_Count(const index_t node_idx) noexcept;
+        const std::uint32_t*    Neighbours(const index_t node_idx) noexcept;
+
+        modulation_paths_t      Search(const index_t                source_idx,
+                                       const index_t                target_idx = modulation_paths_t::NO_NODE,
+                                       thread_pool_t* const         thread_pool = nullptr);
+        std::vector<index_t>    Shortest_Path(const index_t         source_idx,
+                                              const index_t         target_idx,
+                                              thread_pool_t* const  thread_pool = nullptr);
     };
 
 }
@@ -8,439 +8,5858 @@
 
 namespace musical_calculator {
 
-    void
-        mode_t::Print(const note_t* const notes, const count_t note_count)
-        noexcept
+    constexpr wide_count_t::wide_count_t() noexcept :
+        high(0),
+        low(0)
     {
-        std::string note_string = "";
-        for (index_t idx = 0, end = note_count; idx < end; idx += 1) {
-            note_string.push_back('0' + static_cast<char>(notes[idx]));
-        }
-        std::cout << note_string << std::endl;
     }
 
-    void
-        mode_t::Print(const mode_t& mode)
-        noexcept
+    constexpr wide_count_t::wide_count_t(const std::uint64_t low) noexcept :
+        high(0),
+        low(low)
     {
-        return Print(mode.notes, mode.note_count);
     }
 
-    void
-        mode_t::Print(mode_t&& mode)
-        noexcept
+    constexpr wide_count_t::wide_count_t(const std::uint64_t high, const std::uint64_t low) noexcept :
+        high(high),
+        low(low)
     {
-        return Print(mode.notes, mode.note_count);
     }
 
-    mode_t::mode_t(const note_t* const notes, const count_t note_count) noexcept :
-        notes(notes),
-        note_count(note_count)
+    constexpr bool
+        wide_count_t::Is_Count()
+        const noexcept
     {
-        assert(this->notes);
-        assert(this->note_count > 0);
+        return this->high == 0 && this->low <= std::uint64_t(static_cast<count_t>(~count_t(0)));
     }
 
-    count_t
-        mode_t::Note_Count()
-        noexcept
+    constexpr count_t
+        wide_count_t::Count()
+        const noexcept
     {
-        return this->note_count;
-    }
+        assert(Is_Count());
 
-    const note_t*
-        mode_t::Notes()
-        noexcept
-    {
-        return this->notes;
+        return static_cast<count_t>(this->low);
     }
 
-    note_t
-        mode_t::Note(index_t index)
-        noexcept
+    inline std::string
+        wide_count_t::String()
+        const
     {
-        assert(index < Note_Count());
+        std::string result = "";
+        wide_count_t count = *this;
+        do {
+            result.push_back('0' + static_cast<char>(count % 10));
+            count /= 10;
+        } while (count.high != 0 || count.low != 0);
 
-        return this->notes[index];
+        return std::string(result.rbegin(), result.rend());
     }
 
-    void
-        mode_t::Print()
+    constexpr wide_count_t&
+        wide_count_t::operator +=(const wide_count_t& other)
         noexcept
     {
-        return Print(this->notes, this->note_count);
+        const std::uint64_t low = this->low + other.low;
+        this->high = this->high + other.high + (low < this->low ? 1 : 0);
+        this->low = low;
+
+        return *this;
     }
 
-    note_t
-        mode_t::operator [](index_t index)
+    constexpr wide_count_t&
+        wide_count_t::operator -=(const wide_count_t& other)
         noexcept
     {
-        return Note(index);
-    }
-
-}
+        assert(!(*this < other));
 
-namespace musical_calculator {
+        const std::uint64_t low = this->low - other.low;
+        this->high = this->high - other.high - (this->low < other.low ? 1 : 0);
+        this->low = low;
 
-    scale_t::scale_t(const note_t* const notes, const count_t note_count) noexcept :
-        mode_t(notes, note_count)
-    {
+        return *this;
     }
 
-}
+    constexpr wide_count_t&
+        wide_count_t::operator *=(const std::uint32_t factor)
+        noexcept
+    {
+        // we multiply one 32 bit half at a time so that no product can overflow 64 bits.
+        std::uint64_t halves[4] = { this->low & 0xFFFFFFFF, this->low >> 32, this->high & 0xFFFFFFFF, this->high >> 32 };
+        std::uint64_t carry = 0;
+        for (index_t idx = 0, end = 4; idx < end; idx += 1) {
+            const std::uint64_t product = halves[idx] * factor + carry;
+            halves[idx] = product & 0xFFFFFFFF;
+            carry = product >> 32;
+        }
+        assert(carry == 0);
 
-namespace musical_calculator {
+        this->low = halves[0] | (halves[1] << 32);
+        this->high = halves[2] | (halves[3] << 32);
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    mode_tier_t<CHROMATIC_NOTE_COUNT_p>::mode_tier_t() noexcept :
-        notes(nullptr)
-    {
+        return *this;
     }
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    mode_tier_t<CHROMATIC_NOTE_COUNT_p>::mode_tier_t(note_t* notes, const count_t mode_note_count) noexcept :
-        notes(notes)
+    constexpr wide_count_t&
+        wide_count_t::operator /=(const std::uint32_t divisor)
+        noexcept
     {
-        assert(this->notes);
-        assert(mode_note_count > 0);
-        assert(mode_note_count <= CHROMATIC_NOTE_COUNT_p);
-
-        std::vector<note_t> mode_cache;
-        mode_cache.reserve(mode_note_count);
+        assert(divisor > 0);
 
-        // the first mode is simply all the possible notes that can be taken
-        // from the chromatic scale without any skips, up to the mode_note_count.
-        for (note_t note = 1, last_note = mode_note_count; note <= last_note; note += 1) {
-            mode_cache.push_back(note);
-        }
-        for (index_t idx = 0, end = mode_note_count; idx < end; idx += 1) {
-            *notes = mode_cache[idx];
-            notes += 1;
+        // long division, one 32 bit half at a time from the most significant down.
+        std::uint64_t halves[4] = { this->low & 0xFFFFFFFF, this->low >> 32, this->high & 0xFFFFFFFF, this->high >> 32 };
+        std::uint64_t remainder = 0;
+        for (index_t idx = 4; idx > 0; idx -= 1) {
+            const std::uint64_t dividend = (remainder << 32) | halves[idx - 1];
+            halves[idx - 1] = dividend / divisor;
+            remainder = dividend % divisor;
         }
 
-        // we never change the first place, so if that's all there is, we go ahead and return.
-        if (mode_note_count > 1) {
-            // we can now proceed to mutate the mode by incrementing each place
-            // from the least significant digit to the most significant digit.
-            // we do not increment a place past the value of the lesser place to its
-            // right, thus we end up with combinations instead of permutations.
-            while (true) {
-                // get the least significant digit iterations first,
-                // because we can't check a lesser place. Therefore it
-                // can allow upto the total number of notes possible.
-                while (mode_cache[mode_note_count - 1] + 1 <= CHROMATIC_NOTE_COUNT_p) {
-                    mode_cache[mode_note_count - 1] += 1;
-                    for (index_t idx = 0, end = mode_note_count; idx < end; idx += 1) {
-                        *notes = mode_cache[idx];
-                        notes += 1;
-                    }
-                }
-
-                // we need to find a greater place that can be incremented.
-                // if it doesn't exist, then we are finished. we don't consider
-                // idx 0 because we're only working with the one key, and so it
-                // can never be more than 1, and is thus never incrementable.
-                index_t next_idx = 0;
-                bool found_next_idx = false;
-                for (index_t idx = mode_note_count - 2; idx > 0; idx -= 1) {
-                    if (mode_cache[idx] + 1 < mode_cache[idx + 1]) {
-                        next_idx = idx;
-                        found_next_idx = true;
-
-                        break;
-                    }
-                }
-
-                // if we did find it, we increment the place by one and reset
-                // the lesser places for another iteration of while(true).
-                if (found_next_idx) {
-                    mode_cache[next_idx] += 1;
-                    for (index_t idx = next_idx + 1, end = mode_cache.size(); idx < end; idx += 1) {
-                        mode_cache[idx] = mode_cache[idx - 1] + 1;
-                    }
-                    for (index_t idx = 0, end = mode_note_count; idx < end; idx += 1) {
-                        *notes = mode_cache[idx];
-                        notes += 1;
-                    }
+        this->low = halves[0] | (halves[1] << 32);
+        this->high = halves[2] | (halves[3] << 32);
 
-                    continue;
-                } else {
-                    break;
-                }
-            }
-        }
+        return *this;
     }
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    void
-        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Print_Modes(count_t mode_count, count_t mode_note_count)
-        noexcept
+    constexpr std::uint32_t
+        wide_count_t::operator %(const std::uint32_t divisor)
+        const noexcept
     {
-        const note_t* note = this->notes;
-        const note_t* notes_end = this->notes + (mode_count * mode_note_count);
-        for (; note < notes_end; note += mode_note_count) {
-            mode_t::Print(note, mode_note_count);
+        assert(divisor > 0);
+
+        const std::uint64_t halves[4] = { this->low & 0xFFFFFFFF, this->low >> 32, this->high & 0xFFFFFFFF, this->high >> 32 };
+        std::uint64_t remainder = 0;
+        for (index_t idx = 4; idx > 0; idx -= 1) {
+            remainder = ((remainder << 32) | halves[idx - 1]) % divisor;
         }
+
+        return static_cast<std::uint32_t>(remainder);
     }
 
 }
 
 namespace musical_calculator {
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    void
-        scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Scale_Modes(const note_t* scale,
-                                                          const count_t scale_note_count,
-                                                          note_t* const results)
+    constexpr count_t
+        Count_Totient(count_t number)
         noexcept
     {
-        // the first mode is always going to be the scale (or first mode) that is passed in.
-        for (index_t idx = 0, end = scale_note_count; idx < end; idx += 1) {
-            results[idx] = scale[idx];
+        count_t result = number;
+        for (count_t factor = 2; factor * factor <= number; factor += 1) {
+            if (number % factor == 0) {
+                while (number % factor == 0) {
+                    number /= factor;
+                }
+                result -= result / factor;
+            }
+        }
+        if (number > 1) {
+            result -= result / number;
         }
 
-        for (index_t previous_mode_idx = 0, previous_mode_end = scale_note_count * scale_note_count - scale_note_count;
-             previous_mode_idx < previous_mode_end;
-             previous_mode_idx += scale_note_count) {
-            const index_t this_mode_idx = previous_mode_idx + scale_note_count;
+        return result;
+    }
 
-            // first, we revolve the actual notes as they appear from the previous mode.
-            // then we set the last new note to the previous's first + the chromatic_note_count.
-            for (index_t note_idx = 0, note_end = scale_note_count - 1;
-                 note_idx < note_end;
-                 note_idx += 1) {
-                results[this_mode_idx + note_idx] = results[previous_mode_idx + note_idx + 1];
-            }
-            results[this_mode_idx + scale_note_count - 1] = results[previous_mode_idx + 0] + CHROMATIC_NOTE_COUNT_p;
+    constexpr wide_count_t
+        Count_Combinations(const count_t count, const count_t choice_count)
+        noexcept
+    {
+        assert(count <= MAX_COUNTED_CHROMATIC_NOTE_COUNT);
 
-            // then for each subsequent note we add the total note count and subtract by new_first_note - 1.
-            const count_t first_note_diff = results[this_mode_idx + 0] - 1;
-            for (index_t note_idx = 0, note_end = scale_note_count;
-                 note_idx < note_end;
-                 note_idx += 1) {
-                results[this_mode_idx + note_idx] = results[this_mode_idx + note_idx] - first_note_diff;
+        if (choice_count > count) {
+            return 0;
+        }
+
+        // we build up one row of Pascal's triangle at a time, which only ever adds, and so
+        // never overflows on the way to a result that fits. only the first choice_count + 1
+        // columns of each row are needed.
+        wide_count_t row[MAX_COUNTED_CHROMATIC_NOTE_COUNT + 1] = {};
+        row[0] = 1;
+        for (index_t row_idx = 1, row_end = count + 1; row_idx < row_end; row_idx += 1) {
+            for (index_t column_idx = std::min(row_idx, choice_count); column_idx > 0; column_idx -= 1) {
+                row[column_idx] += row[column_idx - 1];
             }
         }
-    }
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    scale_tier_t<CHROMATIC_NOTE_COUNT_p>::scale_tier_t() noexcept
-    {
+        return row[choice_count];
     }
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    scale_tier_t<CHROMATIC_NOTE_COUNT_p>::scale_tier_t(const mode_tier_t<CHROMATIC_NOTE_COUNT_p>&   mode_tier,
-                                                       const count_t                                mode_count,
-                                                       const count_t                                mode_note_count)
+    constexpr wide_count_t
+        Count_Tier_Modes(const count_t chromatic_note_count, const count_t mode_note_count)
+        noexcept
     {
-        // we use this to successively generate all of mode's deriviations performantly
-        note_t* note_cache = static_cast<note_t*>(malloc(sizeof(note_t) * mode_note_count * mode_note_count));
-        assert(note_cache != nullptr);
+        assert(chromatic_note_count > 0);
+        assert(mode_note_count > 0);
+        assert(mode_note_count <= chromatic_note_count);
 
-        // once we know all the static values for each chromatic, we can do this up front for performance.
-        //this->scales.reserve(0);
+        // the first note is always 1, so only the others are chosen.
+        return Count_Combinations(chromatic_note_count - 1, mode_note_count - 1);
+    }
 
-        // We iterate over the modes to generate an array of pointers to the first occurence of unique scales.
-        // We can do this extremely cheaply by utilizing the fact that we generate the modes in numerical order.
-        // It is always the case then that the first occurence of a unique scale will be the mode in a set that equates
-        // to the lowest numerical number. Therefore if we see a mode that is numerically bigger than it deriviations
-        // we know we have already added that mode's scale to the array. We completely avoid lookups doing this,
-        // and thus achieve a high level of efficiency and performance while working with the massive number of
-        // modes that exist in the larger chromatic scales and their tiers of modes.
-        auto Has_Mode_Scale = [](const std::vector<const note_t*>&  scales,
-                                 const note_t*                      mode,
-                                 const count_t                      mode_note_count,
-                                 note_t* const                      note_cache) -> bool
-        {
-            // we cache all the possible deriviations or revolutions of the mode.
-            // notice that we do not allocate and deallocate memory, which would be very non-performant
-            Scale_Modes(mode, mode_note_count, note_cache);
+    constexpr wide_count_t
+        Count_Modes(const count_t chromatic_note_count)
+        noexcept
+    {
+        assert(chromatic_note_count > 0);
+        assert(chromatic_note_count <= MAX_COUNTED_CHROMATIC_NOTE_COUNT);
 
-            // if the first mode is numerically smaller than its deriviations, it's the first occurence of a unique scale
-            for (index_t mode_idx = mode_note_count, mode_end = mode_note_count * mode_note_count;
-                 mode_idx < mode_end;
-                 mode_idx += mode_note_count) {
-                for (index_t note_idx = 1, note_end = mode_note_count;
-                     note_idx < note_end;
-                     note_idx += 1) {
-                    if (note_cache[note_idx] > note_cache[mode_idx + note_idx]) {
-                        return true;
-                    } else if (note_cache[note_idx] < note_cache[mode_idx + note_idx]) {
-                        break;
-                    }
-                }
-            }
+        // every note but the first is either in a mode or not.
+        const count_t exponent = chromatic_note_count - 1;
+        if (exponent < 64) {
+            return wide_count_t(0, std::uint64_t(1) << exponent);
+        } else {
+            return wide_count_t(std::uint64_t(1) << (exponent - 64), 0);
+        }
+    }
 
-            return false;
-        };
+    constexpr wide_count_t
+        Count_Tier_Scales(const count_t chromatic_note_count, const count_t scale_note_count)
+        noexcept
+    {
+        assert(chromatic_note_count > 0);
+        assert(chromatic_note_count <= MAX_COUNTED_CHROMATIC_NOTE_COUNT);
+        assert(scale_note_count > 0);
+        assert(scale_note_count <= chromatic_note_count);
 
-        for (index_t modes_idx = 0, modes_end = mode_count * mode_note_count;
-             modes_idx < modes_end;
-             modes_idx += mode_note_count) {
-            const note_t* const mode = mode_tier.notes + modes_idx;
-            if (!Has_Mode_Scale(this->scales, mode, mode_note_count, note_cache)) {
-                scales.push_back(mode);
+        const count_t divisor_end = std::gcd(chromatic_note_count, scale_note_count) + 1;
+        wide_count_t count = 0;
+        for (count_t divisor = 1; divisor < divisor_end; divisor += 1) {
+            if (chromatic_note_count % divisor == 0 && scale_note_count % divisor == 0) {
+                count += Count_Combinations(chromatic_note_count / divisor, scale_note_count / divisor) *
+                    static_cast<std::uint32_t>(Count_Totient(divisor));
             }
         }
 
-        free(note_cache);
+        return count / static_cast<std::uint32_t>(chromatic_note_count);
     }
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    void
-        scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Print_Scales(const count_t scale_note_count)
+    constexpr wide_count_t
+        Count_Scales(const count_t chromatic_note_count)
         noexcept
     {
-        for (index_t idx = 0, end = this->scales.size(); idx < end; idx += 1) {
-            const note_t* const scale = this->scales[idx];
-            std::string scale_string = "";
-            for (index_t idx = 0, end = scale_note_count; idx < end; idx += 1) {
-                scale_string.push_back('0' + static_cast<char>(scale[idx]));
-            }
-            std::cout << scale_string << std::endl;
+        // we add up the tiers instead of using the formula for all necklaces at once, because
+        // that formula passes through 2 to the power of chromatic_note_count, which doesn't fit.
+        wide_count_t count = 0;
+        for (count_t scale_note_count = 1; scale_note_count <= chromatic_note_count; scale_note_count += 1) {
+            count += Count_Tier_Scales(chromatic_note_count, scale_note_count);
         }
+
+        return count;
     }
 
+    static_assert(Count_Modes(12) == CHROMATIC_MODE_COUNTS[11]);
+    static_assert(Count_Tier_Modes(24, 12) == CHROMATIC_TIER_MODE_COUNTS[23][11]);
+    static_assert(Count_Tier_Scales(12, 7) == 66);
+    static_assert(Count_Scales(12) == 351);
+    static_assert(Count_Scales(24) == 699251);
+
 }
 
 namespace musical_calculator {
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    chromatic_t<CHROMATIC_NOTE_COUNT_p>::chromatic_t()
+    constexpr mask_t
+        Note_Mask(const note_t note)
+        noexcept
     {
-        // We allocate enough memory to store all modes in the chromatic scale in one place,
-        // primary for performance purposes and to avoid using more memory than necessary when dissecting the modes.
-        this->notes = static_cast<note_t*>(malloc(sizeof(note_t) * CHROMATIC_MODE_NOTE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1]));
-        assert(this->notes != nullptr);
-
-        // We concurrently computate modes and subsequently their scales.
-        // Each mode tier and thus scale tier does not rely on any other tier.
-        // Some tiers take way longer to calcuate than others. Some shouldn't
-        // even be done concurrently because it would be faster to just do them
-        // in this thread. We currently do all tiers concurrently just because it's
-        // simpler to write and read, and the time saved is currently not significant.
-        note_t* notes = this->notes;
-        std::vector<std::jthread> threads;
-        threads.reserve(CHROMATIC_NOTE_COUNT_p);
-        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
-            threads.push_back(std::jthread(
-                [this, notes, idx]() -> void
-                {
-                    // we always have to calcuate each tier's modes before each tier's scales.
-                    this->mode_tiers[idx] = mode_tier_t<CHROMATIC_NOTE_COUNT_p>(notes, idx + 1);
+        assert(note > 0);
+        assert(note <= MAX_MASK_NOTE_COUNT);
 
-                    this->scale_tiers[idx] = scale_tier_t<CHROMATIC_NOTE_COUNT_p>(
-                        this->mode_tiers[idx],
-                        CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][idx],
-                        idx + 1);
-                }
-            ));
+        return mask_t(1) << (note - 1);
+    }
 
-            notes += CHROMATIC_TIER_MODE_NOTE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][idx];
-        }
-        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
-            threads[idx].join();
+    constexpr mask_t
+        Notes_Mask(const note_t* const notes, const count_t note_count)
+        noexcept
+    {
+        mask_t mask = 0;
+        for (index_t idx = 0, end = note_count; idx < end; idx += 1) {
+            mask |= Note_Mask(notes[idx]);
         }
+
+        return mask;
     }
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    chromatic_t<CHROMATIC_NOTE_COUNT_p>::~chromatic_t()
+    constexpr count_t
+        Mask_Note_Count(const mask_t mask)
         noexcept
     {
-        free(this->notes);
+        return static_cast<count_t>(std::popcount(mask));
     }
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    constexpr count_t
-        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Chromatic_Note_Count()
+    constexpr note_t
+        Mask_Note(mask_t mask, const index_t index)
         noexcept
     {
-        return CHROMATIC_NOTE_COUNT_p;
+        assert(index < Mask_Note_Count(mask));
+
+        // we clear the lowest set bit once for every note that comes before the one we want.
+        for (index_t idx = 0, end = index; idx < end; idx += 1) {
+            mask &= mask - 1;
+        }
+
+        return static_cast<note_t>(std::countr_zero(mask)) + 1;
     }
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    constexpr count_t
-        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Mode_Count()
+    constexpr void
+        Mask_Notes(mask_t mask, note_t* const results)
         noexcept
     {
-        return CHROMATIC_MODE_COUNTS[Chromatic_Note_Count() - 1];
+        for (index_t idx = 0; mask != 0; idx += 1, mask &= mask - 1) {
+            results[idx] = static_cast<note_t>(std::countr_zero(mask)) + 1;
+        }
     }
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    count_t
-        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Scale_Count()
+    constexpr mask_t
+        Chromatic_Mask(const count_t chromatic_note_count)
         noexcept
     {
-        count_t count = 0;
-        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
-            count += this->scale_tiers[idx].scales.size();
+        assert(chromatic_note_count > 0);
+        assert(chromatic_note_count <= MAX_MASK_NOTE_COUNT);
+
+        return static_cast<mask_t>(~mask_t(0)) >> (MAX_MASK_NOTE_COUNT - chromatic_note_count);
+    }
+
+    constexpr mask_t
+        Revolve_Mask(const mask_t mask, const index_t distance, const count_t chromatic_note_count)
+        noexcept
+    {
+        assert(distance < chromatic_note_count);
+
+        // the note found at (distance + 1) becomes the new 1, and the notes below it wrap around to the top.
+        if (distance == 0) {
+            return mask;
+        } else {
+            return ((mask >> distance) | (mask << (chromatic_note_count - distance))) & Chromatic_Mask(chromatic_note_count);
         }
+    }
 
-        return count;
+    constexpr bool
+        Mask_Precedes(const mask_t mask, const mask_t other_mask)
+        noexcept
+    {
+        // modes of the same tier are generated in numerical order of their notes. the first note in
+        // which two modes differ decides which is first, and that note is the lowest bit in which the
+        // masks differ. whichever mask has that bit set has the smaller note there, and so comes first.
+        const mask_t difference = mask ^ other_mask;
+
+        return (difference & (~difference + 1) & mask) != 0;
     }
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    std::vector<mode_t>
-        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Modes()
+    constexpr bool
+        Is_Scale_Mask(const mask_t mask, const count_t chromatic_note_count)
+        noexcept
     {
-        std::vector<mode_t> modes;
-        modes.reserve(Mode_Count());
+        assert(mask & 1);
 
-        for (index_t tier_idx = 0, tier_end = CHROMATIC_NOTE_COUNT_p;
-             tier_idx < tier_end;
-             tier_idx += 1) {
-            const count_t tier_mode_count = CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][tier_idx];
-            const count_t mode_note_count = tier_idx + 1;
-            for (index_t mode_idx = 0, mode_end = tier_mode_count * mode_note_count;
-                 mode_idx < mode_end;
-                 mode_idx += mode_note_count) {
-                modes.push_back(mode_t(this->mode_tiers[tier_idx].notes + mode_idx, mode_note_count));
+        // a mode is the first occurence of its scale when none of its revolutions come before it.
+        // there is one revolution for each note after the first, and each costs only a few word operations.
+        for (mask_t notes = mask & (mask - 1); notes != 0; notes &= notes - 1) {
+            const index_t distance = static_cast<index_t>(std::countr_zero(notes));
+            if (Mask_Precedes(Revolve_Mask(mask, distance, chromatic_note_count), mask)) {
+                return false;
             }
         }
 
-        return modes;
+        return true;
     }
 
-    template <count_t CHROMATIC_NOTE_COUNT_p>
-    std::vector<scale_t>
-        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Scales()
+    constexpr mask_t
+        Next_Mask(const mask_t mask, const count_t chromatic_note_count)
+        noexcept
     {
-        std::vector<scale_t> scales;
-        scales.reserve(Scale_Count());
+        assert(mask & 1);
 
+        // when the last note can go up, it does. otherwise the notes at the top of the chromatic are a run,
+        // and the note below the run goes up one and takes the run down with it to just above itself.
+        // when there is no note below the run other than 1, which never moves, the tier is done.
+        const index_t last_bit = static_cast<index_t>(std::bit_width(mask)) - 1;
+        if (last_bit == 0) {
+            return 0;
+        } else if (last_bit + 1 < chromatic_note_count) {
+            return mask ^ (mask_t(0b11) << last_bit);
+        } else {
+            const count_t run_note_count = static_cast<count_t>(std::countl_one(static_cast<mask_t>(mask << (MAX_MASK_NOTE_COUNT - chromatic_note_count))));
+            if (run_note_count == chromatic_note_count) {
+                return 0;
+            }
+
+            const mask_t below_run = mask & Chromatic_Mask(chromatic_note_count - run_note_count);
+            const index_t below_run_bit = static_cast<index_t>(std::bit_width(below_run)) - 1;
+            if (below_run_bit == 0) {
+                return 0;
+            } else {
+                return
+                    (below_run ^ (mask_t(1) << below_run_bit)) |
+                    (mask_t(1) << (below_run_bit + 1)) |
+                    (Chromatic_Mask(run_note_count) << (below_run_bit + 2));
+            }
+        }
+    }
+
+    constexpr mask_t
+        Invert_Mask(const mask_t mask, const count_t chromatic_note_count)
+        noexcept
+    {
+        assert(mask & 1);
+
+        // 1 stays where it is, and every other note is as far below the next 1 as it was above this one.
+        mask_t inversion = 1;
+        for (mask_t notes = mask & (mask - 1); notes != 0; notes &= notes - 1) {
+            inversion |= mask_t(1) << (chromatic_note_count - static_cast<index_t>(std::countr_zero(notes)));
+        }
+
+        return inversion;
+    }
+
+    constexpr mask_t
+        Scale_Mask(const mask_t mask, const count_t chromatic_note_count)
+        noexcept
+    {
+        assert(mask & 1);
+
+        mask_t scale = mask;
+        for (mask_t notes = mask & (mask - 1); notes != 0; notes &= notes - 1) {
+            const mask_t revolution = Revolve_Mask(mask, static_cast<index_t>(std::countr_zero(notes)), chromatic_note_count);
+            if (Mask_Precedes(revolution, scale)) {
+                scale = revolution;
+            }
+        }
+
+        return scale;
+    }
+
+    constexpr mask_t
+        Bracelet_Mask(const mask_t mask, const count_t chromatic_note_count)
+        noexcept
+    {
+        const mask_t scale = Scale_Mask(mask, chromatic_note_count);
+        const mask_t inversion_scale = Scale_Mask(Invert_Mask(mask, chromatic_note_count), chromatic_note_count);
+
+        return Mask_Precedes(inversion_scale, scale) ? inversion_scale : scale;
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline simd_e
+        Simd_Level()
+        noexcept
+    {
+        static const simd_e simd = []() -> simd_e
+        {
+#if defined(MUSICAL_CALCULATOR_X86) && defined(_MSC_VER)
+            // AVX2 needs both the processor to have it and the OS to save the wider registers.
+            int registers[4];
+            __cpuid(registers, 0);
+            if (registers[0] >= 7) {
+                __cpuid(registers, 1);
+                const bool has_os_avx = (registers[2] & (1 << 27)) && (registers[2] & (1 << 28)) && (_xgetbv(0) & 0x6) == 0x6;
+                __cpuidex(registers, 7, 0);
+                if (has_os_avx && (registers[1] & (1 << 5))) {
+                    return simd_e::AVX2;
+                }
+            }
+            return simd_e::SSE2;
+#elif defined(MUSICAL_CALCULATOR_X86)
+            __builtin_cpu_init();
+            if (__builtin_cpu_supports("avx2")) {
+                return simd_e::AVX2;
+            } else if (__builtin_cpu_supports("sse2")) {
+                return simd_e::SSE2;
+            } else {
+                return simd_e::SCALAR;
+            }
+#else
+            return simd_e::SCALAR;
+#endif
+        }();
+
+        return simd;
+    }
+
+    inline void
+        Classify_Scale_Masks_Scalar(const mask_t* const masks,
+                                    const count_t       mask_count,
+                                    const count_t       chromatic_note_count,
+                                    std::uint8_t* const is_scales)
+        noexcept
+    {
+        // one at a time, branching out as soon as a revolution comes first is faster than any branchless form.
+        for (index_t idx = 0, end = mask_count; idx < end; idx += 1) {
+            is_scales[idx] = Is_Scale_Mask(masks[idx], chromatic_note_count);
+        }
+    }
+
+#if defined(MUSICAL_CALCULATOR_X86)
+
+    inline void
+        Classify_Scale_Masks_SSE2(const mask_t* const   masks,
+                                  const count_t         mask_count,
+                                  const count_t         chromatic_note_count,
+                                  std::uint8_t* const   is_scales)
+        noexcept
+    {
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i chromatic_mask = _mm_set1_epi32(static_cast<int>(Chromatic_Mask(chromatic_note_count)));
+
+        index_t idx = 0;
+        for (index_t end = mask_count - mask_count % 4; idx < end; idx += 4) {
+            const __m128i mask = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks + idx));
+            __m128i precedes = zero;
+            for (index_t distance = 1; distance < chromatic_note_count; distance += 1) {
+                const __m128i revolution = _mm_and_si128(
+                    _mm_or_si128(
+                        _mm_srl_epi32(mask, _mm_cvtsi32_si128(static_cast<int>(distance))),
+                        _mm_sll_epi32(mask, _mm_cvtsi32_si128(static_cast<int>(chromatic_note_count - distance)))),
+                    chromatic_mask);
+                const __m128i difference = _mm_xor_si128(revolution, mask);
+                const __m128i lowest_difference = _mm_and_si128(difference, _mm_sub_epi32(zero, difference));
+                precedes = _mm_or_si128(precedes, _mm_and_si128(lowest_difference, revolution));
+
+                // most modes aren't scales and are found out within a few revolutions, and once every lane is, we can stop.
+                if (_mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(precedes, zero))) == 0) {
+                    break;
+                }
+            }
+
+            // each lane is all ones when nothing preceded it, and the low bit of each lane's bytes gives its flag.
+            const int is_scale_bits = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(precedes, zero)));
+            for (index_t lane = 0; lane < 4; lane += 1) {
+                is_scales[idx + lane] = (is_scale_bits >> lane) & 1;
+            }
+        }
+        Classify_Scale_Masks_Scalar(masks + idx, mask_count - idx, chromatic_note_count, is_scales + idx);
+    }
+
+    #if defined(__GNUC__) || defined(__clang__)
+    __attribute__((target("avx2")))
+    #endif
+    inline void
+        Classify_Scale_Masks_AVX2(const mask_t* const   masks,
+                                  const count_t         mask_count,
+                                  const count_t         chromatic_note_count,
+                                  std::uint8_t* const   is_scales)
+        noexcept
+    {
+        const __m256i zero = _mm256_setzero_si256();
+        const __m256i chromatic_mask = _mm256_set1_epi32(static_cast<int>(Chromatic_Mask(chromatic_note_count)));
+
+        index_t idx = 0;
+        for (index_t end = mask_count - mask_count % 8; idx < end; idx += 8) {
+            const __m256i mask = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(masks + idx));
+            __m256i precedes = zero;
+            for (index_t distance = 1; distance < chromatic_note_count; distance += 1) {
+                const __m256i revolution = _mm256_and_si256(
+                    _mm256_or_si256(
+                        _mm256_srl_epi32(mask, _mm_cvtsi32_si128(static_cast<int>(distance))),
+                        _mm256_sll_epi32(mask, _mm_cvtsi32_si128(static_cast<int>(chromatic_note_count - distance)))),
+                    chromatic_mask);
+                const __m256i difference = _mm256_xor_si256(revolution, mask);
+                const __m256i lowest_difference = _mm256_and_si256(difference, _mm256_sub_epi32(zero, difference));
+                precedes = _mm256_or_si256(precedes, _mm256_and_si256(lowest_difference, revolution));
+
+                // most modes aren't scales and are found out within a few revolutions, and once every lane is, we can stop.
+                if (_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(precedes, zero))) == 0) {
+                    break;
+                }
+            }
+
+            const int is_scale_bits = _mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(precedes, zero)));
+            for (index_t lane = 0; lane < 8; lane += 1) {
+                is_scales[idx + lane] = (is_scale_bits >> lane) & 1;
+            }
+        }
+        Classify_Scale_Masks_Scalar(masks + idx, mask_count - idx, chromatic_note_count, is_scales + idx);
+    }
+
+#endif
+
+    inline void
+        Classify_Scale_Masks(const mask_t* const    masks,
+                             const count_t          mask_count,
+                             const count_t          chromatic_note_count,
+                             std::uint8_t* const    is_scales,
+                             const simd_e           simd)
+        noexcept
+    {
+        assert(chromatic_note_count > 0 && chromatic_note_count <= MAX_MASK_NOTE_COUNT);
+
+#if defined(MUSICAL_CALCULATOR_X86)
+        // a batch that doesn't fill even the narrowest vector is left to the scalar loop.
+        if (mask_count < 4) {
+            return Classify_Scale_Masks_Scalar(masks, mask_count, chromatic_note_count, is_scales);
+        } else if (simd == simd_e::AVX2) {
+            return Classify_Scale_Masks_AVX2(masks, mask_count, chromatic_note_count, is_scales);
+        } else if (simd == simd_e::SSE2) {
+            return Classify_Scale_Masks_SSE2(masks, mask_count, chromatic_note_count, is_scales);
+        }
+#endif
+        static_cast<void>(simd);
+
+        return Classify_Scale_Masks_Scalar(masks, mask_count, chromatic_note_count, is_scales);
+    }
+
+}
+
+namespace musical_calculator {
+
+    constexpr count_t
+        Choose(const count_t count, const count_t choice_count)
+        noexcept
+    {
+        if (choice_count > count) {
+            return 0;
+        } else if (count < MAX_CHROMATIC_NOTE_COUNT) {
+            return CHROMATIC_TIER_MODE_COUNTS[count][choice_count];
+        } else {
+            // past the tables, which only happens for chromatics larger than we generate whole,
+            // every partial product is itself a binomial and so the division is always exact.
+            count_t result = 1;
+            for (count_t idx = 1; idx <= choice_count; idx += 1) {
+                result = result * (count - choice_count + idx) / idx;
+            }
+            return result;
+        }
+    }
+
+    constexpr index_t
+        Rank_Mask(const mask_t mask, const count_t chromatic_note_count)
+        noexcept
+    {
+        assert(mask & 1);
+
+        // the modes that match up to the previous note and have a smaller note in this place, between
+        // previous_note + 1 and note - 1, number sum(Choose(chromatic_note_count - smaller_note, remaining_note_count)),
+        // which is Choose(chromatic_note_count - previous_note, remaining_note_count + 1) - Choose(chromatic_note_count - note + 1, remaining_note_count + 1).
+        index_t rank = 0;
+        count_t remaining_note_count = Mask_Note_Count(mask) - 1;
+        note_t previous_note = 1;
+        for (mask_t notes = mask & (mask - 1); notes != 0; notes &= notes - 1) {
+            const note_t note = static_cast<note_t>(std::countr_zero(notes)) + 1;
+            rank += Choose(chromatic_note_count - previous_note, remaining_note_count) -
+                Choose(chromatic_note_count - note + 1, remaining_note_count);
+            remaining_note_count -= 1;
+            previous_note = note;
+        }
+
+        return rank;
+    }
+
+    constexpr mask_t
+        Unrank_Mask(index_t mode_idx, const count_t mode_note_count, const count_t chromatic_note_count)
+        noexcept
+    {
+        assert(mode_note_count > 0);
+        assert(mode_idx < Choose(chromatic_note_count - 1, mode_note_count - 1));
+
+        mask_t mask = 1;
+        note_t note = 1;
+        for (count_t remaining_note_count = mode_note_count - 1; remaining_note_count > 0; remaining_note_count -= 1) {
+            // each smaller note in this place accounts for all the modes that can follow it.
+            note += 1;
+            for (count_t skipped_count = Choose(chromatic_note_count - note, remaining_note_count - 1);
+                 mode_idx >= skipped_count;
+                 skipped_count = Choose(chromatic_note_count - note, remaining_note_count - 1)) {
+                mode_idx -= skipped_count;
+                note += 1;
+            }
+            mask |= Note_Mask(note);
+        }
+
+        return mask;
+    }
+
+    constexpr index_t
+        Tier_First_Mode_Index(const count_t mode_note_count, const count_t chromatic_note_count)
+        noexcept
+    {
+        assert(mode_note_count > 0);
+        assert(mode_note_count <= chromatic_note_count);
+
+        index_t mode_idx = 0;
+        for (count_t note_count = 1; note_count < mode_note_count; note_count += 1) {
+            mode_idx += Choose(chromatic_note_count - 1, note_count - 1);
+        }
+
+        return mode_idx;
+    }
+
+    constexpr index_t
+        Mode_Index(const mask_t mask, const count_t chromatic_note_count)
+        noexcept
+    {
+        return Tier_First_Mode_Index(Mask_Note_Count(mask), chromatic_note_count) + Rank_Mask(mask, chromatic_note_count);
+    }
+
+    constexpr mask_t
+        Mode_Index_Mask(index_t mode_idx, const count_t chromatic_note_count)
+        noexcept
+    {
+        for (count_t mode_note_count = 1; mode_note_count <= chromatic_note_count; mode_note_count += 1) {
+            const count_t tier_mode_count = Choose(chromatic_note_count - 1, mode_note_count - 1);
+            if (mode_idx < tier_mode_count) {
+                return Unrank_Mask(mode_idx, mode_note_count, chromatic_note_count);
+            }
+            mode_idx -= tier_mode_count;
+        }
+        assert(false);
+
+        return 0;
+    }
+
+    static_assert(Rank_Mask(0b1, 1) == 0);
+    static_assert(Rank_Mask(0b111, 12) == 0);
+    static_assert(Rank_Mask(0b110000000001, 12) == 54);
+    static_assert(Unrank_Mask(54, 3, 12) == 0b110000000001);
+    static_assert(Mode_Index_Mask(Mode_Index(0b101010110101, 12), 12) == 0b101010110101);
+
+}
+
+namespace musical_calculator {
+
+    void
+        mode_t::Print(const note_t* const notes, const count_t note_count)
+        noexcept
+    {
+        // we leave flushing to the stream, as flushing every line makes printing many modes bound by the writes.
+        char line[writer_t::MAX_FORMATTED_MODE_SIZE];
+        const char* const line_end = writer_t::Format_Notes(line, notes, note_count, format_e::TEXT);
+        std::cout.write(line, line_end - line);
+    }
+
+    void
+        mode_t::Print(const mode_t& mode)
+        noexcept
+    {
+        if (mode.notes) {
+            return Print(mode.notes, mode.note_count);
+        } else {
+            note_t notes[MAX_MASK_NOTE_COUNT];
+            Mask_Notes(mode.mask, notes);
+            return Print(notes, mode.note_count);
+        }
+    }
+
+    void
+        mode_t::Print(mode_t&& mode)
+        noexcept
+    {
+        return Print(static_cast<const mode_t&>(mode));
+    }
+
+    mode_t::mode_t(const note_t* const notes, const count_t note_count) noexcept :
+        notes(notes),
+        note_count(note_count),
+        mask(0)
+    {
+        assert(this->notes);
+        assert(this->note_count > 0);
+    }
+
+    mode_t::mode_t(const mask_t mask) noexcept :
+        notes(nullptr),
+        note_count(Mask_Note_Count(mask)),
+        mask(mask)
+    {
+        assert(this->mask & 1);
+    }
+
+    count_t
+        mode_t::Note_Count()
+        noexcept
+    {
+        return this->note_count;
+    }
+
+    const note_t*
+        mode_t::Notes()
+        noexcept
+    {
+        // a mode that views a mask has no notes to point to, use Copy_Notes instead.
+        assert(this->notes);
+
+        return this->notes;
+    }
+
+    note_t
+        mode_t::Note(index_t index)
+        noexcept
+    {
+        assert(index < Note_Count());
+
+        if (this->notes) {
+            return this->notes[index];
+        } else {
+            return Mask_Note(this->mask, index);
+        }
+    }
+
+    void
+        mode_t::Copy_Notes(note_t* const results)
+        noexcept
+    {
+        if (this->notes) {
+            for (index_t idx = 0, end = this->note_count; idx < end; idx += 1) {
+                results[idx] = this->notes[idx];
+            }
+        } else {
+            Mask_Notes(this->mask, results);
+        }
+    }
+
+    mask_t
+        mode_t::Mask()
+        noexcept
+    {
+        if (this->notes) {
+            return Notes_Mask(this->notes, this->note_count);
+        } else {
+            return this->mask;
+        }
+    }
+
+    void
+        mode_t::Print()
+        noexcept
+    {
+        return Print(*this);
+    }
+
+    note_t
+        mode_t::operator [](index_t index)
+        noexcept
+    {
+        return Note(index);
+    }
+
+}
+
+namespace musical_calculator {
+
+    scale_t::scale_t(const note_t* const notes, const count_t note_count) noexcept :
+        mode_t(notes, note_count)
+    {
+    }
+
+    scale_t::scale_t(const mask_t mask) noexcept :
+        mode_t(mask)
+    {
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline mode_generator_t::mode_generator_t(const count_t chromatic_note_count,
+                                              const count_t mode_note_count,
+                                              const index_t first_mode_idx) noexcept :
+        chromatic_note_count(chromatic_note_count),
+        mode_note_count(mode_note_count),
+        first_mode_idx(first_mode_idx),
+        mode(),
+        is_started(false),
+        is_done(false)
+    {
+        assert(this->chromatic_note_count > 0);
+        assert(this->chromatic_note_count <= MAX_MASK_NOTE_COUNT);
+        assert(this->mode_note_count > 0);
+        assert(this->mode_note_count <= this->chromatic_note_count);
+    }
+
+    inline bool
+        mode_generator_t::Next(mask_t& result)
+        noexcept
+    {
+        const count_t chromatic_note_count = this->chromatic_note_count;
+        const count_t mode_note_count = this->mode_note_count;
+        note_t* const mode = this->mode;
+
+        if (this->is_done) {
+            return false;
+        }
+
+        if (!this->is_started) {
+            // the first mode is simply the first mode_note_count notes of the chromatic,
+            // unless we were asked to start somewhere further in.
+            this->is_started = true;
+            if (this->first_mode_idx >= Choose(chromatic_note_count - 1, mode_note_count - 1)) {
+                this->is_done = true;
+                return false;
+            }
+            Mask_Notes(Unrank_Mask(this->first_mode_idx, mode_note_count, chromatic_note_count), mode);
+        } else {
+            // we increment the least significant place that still has room, which is every place
+            // whose note is lower than the highest it can be with the places after it still to fill,
+            // and then reset the places after it. the first place is never incremented.
+            index_t idx = mode_note_count - 1;
+            while (idx > 0 && mode[idx] == chromatic_note_count - (mode_note_count - 1 - idx)) {
+                idx -= 1;
+            }
+            if (idx == 0) {
+                this->is_done = true;
+                return false;
+            }
+            mode[idx] += 1;
+            for (idx += 1; idx < mode_note_count; idx += 1) {
+                mode[idx] = mode[idx - 1] + 1;
+            }
+        }
+
+        result = Notes_Mask(mode, mode_note_count);
+
+        return true;
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline scale_generator_t::scale_generator_t(const count_t chromatic_note_count, const count_t scale_note_count) noexcept :
+        chromatic_note_count(chromatic_note_count),
+        scale_note_count(scale_note_count),
+        steps(),
+        step_sums(),
+        periods(),
+        is_started(false),
+        is_done(false)
+    {
+        assert(this->chromatic_note_count > 0);
+        assert(this->chromatic_note_count <= MAX_MASK_NOTE_COUNT);
+        assert(this->scale_note_count > 0);
+        assert(this->scale_note_count <= this->chromatic_note_count);
+    }
+
+    inline bool
+        scale_generator_t::Next(mask_t& result)
+        noexcept
+    {
+        const count_t chromatic_note_count = this->chromatic_note_count;
+        const count_t scale_note_count = this->scale_note_count;
+        count_t* const steps = this->steps;
+        count_t* const step_sums = this->step_sums;
+        count_t* const periods = this->periods;
+
+        if (this->is_done) {
+            return false;
+        }
+
+        // a scale with one note has only the one step that goes all the way around.
+        if (scale_note_count == 1) {
+            this->is_done = true;
+            result = 1;
+            return true;
+        }
+
+        // we always increment a step before using it, so the first scale starts from a step of 0.
+        // every other time we resume from the last step that isn't decided by the steps before it.
+        index_t step_idx;
+        if (!this->is_started) {
+            this->is_started = true;
+            steps[0] = 0;
+            step_idx = 0;
+        } else {
+            step_idx = scale_note_count - 2;
+        }
+
+        const index_t last_idx = scale_note_count - 1;
+        while (true) {
+            // the first step is the smallest step in a necklace, and so each of the remaining steps
+            // must be at least as big. if even that is too much to fit, no bigger step will fit either.
+            steps[step_idx] += 1;
+            const count_t smallest_step = steps[0];
+            const count_t step_sum = (step_idx > 0 ? step_sums[step_idx - 1] : 0) + steps[step_idx];
+            if (step_sum + (last_idx - step_idx) * smallest_step > chromatic_note_count) {
+                if (step_idx == 0) {
+                    this->is_done = true;
+                    return false;
+                } else {
+                    step_idx -= 1;
+                    continue;
+                }
+            }
+            step_sums[step_idx] = step_sum;
+            if (step_idx == 0) {
+                periods[step_idx] = 1;
+            } else if (steps[step_idx] == steps[step_idx - periods[step_idx - 1]]) {
+                periods[step_idx] = periods[step_idx - 1];
+            } else {
+                periods[step_idx] = step_idx + 1;
+            }
+
+            // the smallest steps that can follow simply repeat the steps one period before them.
+            index_t fill_idx = step_idx + 1;
+            for (; fill_idx < last_idx; fill_idx += 1) {
+                steps[fill_idx] = steps[fill_idx - periods[fill_idx - 1]];
+                const count_t fill_sum = step_sums[fill_idx - 1] + steps[fill_idx];
+                if (fill_sum + (last_idx - fill_idx) * smallest_step > chromatic_note_count) {
+                    break;
+                }
+                step_sums[fill_idx] = fill_sum;
+                periods[fill_idx] = periods[fill_idx - 1];
+            }
+            if (fill_idx < last_idx) {
+                step_idx = fill_idx - 1;
+                continue;
+            }
+
+            // the last step is whatever remains of the chromatic. the steps are a necklace when the
+            // last step is bigger than the one a period before it, or when it's equal and the period
+            // divides the steps evenly. otherwise we move on to the next possibility for the step before it.
+            const count_t last_step = chromatic_note_count - step_sums[last_idx - 1];
+            const count_t period_step = steps[last_idx - periods[last_idx - 1]];
+            if (last_step < period_step || (last_step == period_step && scale_note_count % periods[last_idx - 1] != 0)) {
+                step_idx = last_idx - 1;
+                continue;
+            }
+            steps[last_idx] = last_step;
+
+            mask_t mask = 1;
+            for (index_t idx = 0, end = last_idx; idx < end; idx += 1) {
+                mask |= mask_t(1) << step_sums[idx];
+            }
+            result = mask;
+
+            return true;
+        }
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline bracelet_generator_t::bracelet_generator_t(const count_t chromatic_note_count, const count_t scale_note_count) noexcept :
+        scale_generator(chromatic_note_count, scale_note_count),
+        is_chiral(false)
+    {
+    }
+
+    inline bool
+        bracelet_generator_t::Next(mask_t& result)
+        noexcept
+    {
+        const count_t chromatic_note_count = this->scale_generator.chromatic_note_count;
+
+        // a scale that comes after the scale of its inversion was already given as that scale's class.
+        mask_t scale;
+        while (this->scale_generator.Next(scale)) {
+            const mask_t inversion_scale = Scale_Mask(Invert_Mask(scale, chromatic_note_count), chromatic_note_count);
+            if (inversion_scale == scale || Mask_Precedes(scale, inversion_scale)) {
+                this->is_chiral = inversion_scale != scale;
+                result = scale;
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+}
+
+namespace musical_calculator {
+
+    template <typename generator_t, typename view_t>
+    tier_stream_t<generator_t, view_t>::iterator_t::iterator_t() noexcept :
+        stream(nullptr),
+        mask(0),
+        is_done(true)
+    {
+    }
+
+    template <typename generator_t, typename view_t>
+    tier_stream_t<generator_t, view_t>::iterator_t::iterator_t(tier_stream_t& stream) noexcept :
+        stream(&stream),
+        mask(0),
+        is_done(false)
+    {
+        ++(*this);
+    }
+
+    template <typename generator_t, typename view_t>
+    view_t
+        tier_stream_t<generator_t, view_t>::iterator_t::operator *()
+        const noexcept
+    {
+        assert(!this->is_done);
+
+        return view_t(this->mask);
+    }
+
+    template <typename generator_t, typename view_t>
+    typename tier_stream_t<generator_t, view_t>::iterator_t&
+        tier_stream_t<generator_t, view_t>::iterator_t::operator ++()
+        noexcept
+    {
+        this->is_done = !this->stream->Next(this->mask);
+
+        return *this;
+    }
+
+    template <typename generator_t, typename view_t>
+    void
+        tier_stream_t<generator_t, view_t>::iterator_t::operator ++(int)
+        noexcept
+    {
+        ++(*this);
+    }
+
+    template <typename generator_t, typename view_t>
+    tier_stream_t<generator_t, view_t>::tier_stream_t(const count_t chromatic_note_count) noexcept :
+        chromatic_note_count(chromatic_note_count),
+        note_count(1),
+        last_note_count(chromatic_note_count),
+        generator(chromatic_note_count, 1)
+    {
+    }
+
+    template <typename generator_t, typename view_t>
+    tier_stream_t<generator_t, view_t>::tier_stream_t(const count_t chromatic_note_count, const count_t tier_note_count) noexcept :
+        chromatic_note_count(chromatic_note_count),
+        note_count(tier_note_count),
+        last_note_count(tier_note_count),
+        generator(chromatic_note_count, tier_note_count)
+    {
+    }
+
+    template <typename generator_t, typename view_t>
+    bool
+        tier_stream_t<generator_t, view_t>::Next(mask_t& result)
+        noexcept
+    {
+        // when a tier runs out we move on to a fresh generator for the next one.
+        while (!this->generator.Next(result)) {
+            if (this->note_count == this->last_note_count) {
+                return false;
+            }
+            this->note_count += 1;
+            this->generator = generator_t(this->chromatic_note_count, this->note_count);
+        }
+
+        return true;
+    }
+
+    template <typename generator_t, typename view_t>
+    count_t
+        tier_stream_t<generator_t, view_t>::Note_Count()
+        noexcept
+    {
+        return this->note_count;
+    }
+
+    template <typename generator_t, typename view_t>
+    typename tier_stream_t<generator_t, view_t>::iterator_t
+        tier_stream_t<generator_t, view_t>::begin()
+        noexcept
+    {
+        return iterator_t(*this);
+    }
+
+    template <typename generator_t, typename view_t>
+    std::default_sentinel_t
+        tier_stream_t<generator_t, view_t>::end()
+        noexcept
+    {
+        return std::default_sentinel;
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline task_range_t::task_range_t() noexcept :
+        range(0)
+    {
+    }
+
+    inline void
+        task_range_t::Reset(const index_t begin, const index_t end)
+        noexcept
+    {
+        assert(begin <= end);
+        assert(end <= 0xFFFFFFFF);
+
+        // only the owner resets its range, and only once it's empty, at which point no thief will touch it.
+        this->range.store((std::uint64_t(end) << 32) | std::uint64_t(begin), std::memory_order_release);
+    }
+
+    inline bool
+        task_range_t::Take(index_t& result)
+        noexcept
+    {
+        std::uint64_t range = this->range.load(std::memory_order_acquire);
+        while (true) {
+            const index_t begin = static_cast<index_t>(range & 0xFFFFFFFF);
+            const index_t end = static_cast<index_t>(range >> 32);
+            if (begin >= end) {
+                return false;
+            } else if (this->range.compare_exchange_weak(range,
+                                                         (std::uint64_t(end) << 32) | std::uint64_t(begin + 1),
+                                                         std::memory_order_acq_rel)) {
+                result = begin;
+                return true;
+            }
+        }
+    }
+
+    inline bool
+        task_range_t::Steal(task_range_t& victim, index_t& result)
+        noexcept
+    {
+        std::uint64_t range = victim.range.load(std::memory_order_acquire);
+        while (true) {
+            const index_t begin = static_cast<index_t>(range & 0xFFFFFFFF);
+            const index_t end = static_cast<index_t>(range >> 32);
+            if (begin >= end) {
+                return false;
+            }
+
+            // we take the back half, rounding up so that a single task can be stolen too.
+            const index_t middle = begin + (end - begin) / 2;
+            if (victim.range.compare_exchange_weak(range,
+                                                   (std::uint64_t(middle) << 32) | std::uint64_t(begin),
+                                                   std::memory_order_acq_rel)) {
+                result = middle;
+                Reset(middle + 1, end);
+                return true;
+            }
+        }
+    }
+
+    // the pool whose worker is running on this thread, if any. it's how we catch a job started from inside a task.
+    inline thread_local thread_pool_t* current_thread_pool = nullptr;
+
+    inline thread_pool_t&
+        thread_pool_t::Default()
+    {
+        static thread_pool_t thread_pool;
+
+        return thread_pool;
+    }
+
+    inline thread_pool_t&
+        thread_pool_t::Choose(const count_t         item_count,
+                              thread_pool_t* const  thread_pool,
+                              thread_pool_t&        serial_thread_pool,
+                              const count_t         min_parallel_item_count)
+    {
+        assert(serial_thread_pool.Worker_Count() == 1);
+
+        if (item_count < min_parallel_item_count) {
+            return serial_thread_pool;
+        } else if (thread_pool) {
+            return *thread_pool;
+        } else {
+            return Default();
+        }
+    }
+
+    inline thread_pool_t::thread_pool_t(const count_t worker_count, const bool is_pinned) :
+        worker_count(std::max(worker_count, count_t(1))),
+        is_pinned(is_pinned),
+        ranges(this->worker_count),
+        threads(),
+        job_mutex(),
+        state_mutex(),
+        start_condition(),
+        stop_condition(),
+        job_generation(0),
+        active_worker_count(0),
+        is_stopping(false),
+        job_context(nullptr),
+        Run_Job_Task(nullptr),
+        is_job_failed(false),
+        job_exception()
+    {
+        // the calling thread of each job is worker 0, so we only need threads for the rest.
+        this->threads.reserve(this->worker_count - 1);
+        for (index_t worker_idx = 1, worker_end = this->worker_count; worker_idx < worker_end; worker_idx += 1) {
+            this->threads.push_back(std::jthread(&thread_pool_t::Work, this, worker_idx));
+            if (this->is_pinned) {
+                Pin(this->threads.back(), worker_idx);
+            }
+        }
+    }
+
+    inline thread_pool_t::~thread_pool_t()
+        noexcept
+    {
+        {
+            std::lock_guard<std::mutex> state_lock(this->state_mutex);
+            this->is_stopping = true;
+        }
+        this->start_condition.notify_all();
+        for (index_t idx = 0, end = this->threads.size(); idx < end; idx += 1) {
+            this->threads[idx].join();
+        }
+    }
+
+    inline count_t
+        thread_pool_t::Worker_Count()
+        noexcept
+    {
+        return this->worker_count;
+    }
+
+    template <typename Run_Task_f>
+    void
+        thread_pool_t::Run_Tasks(const count_t task_count, Run_Task_f&& Run_Task)
+    {
+        if (task_count == 0) {
+            return;
+        } else if (task_count == 1 || this->worker_count == 1 || current_thread_pool != nullptr) {
+            for (index_t task_idx = 0, task_end = task_count; task_idx < task_end; task_idx += 1) {
+                Run_Task_On_Worker(Run_Task, task_idx, 0);
+            }
+            return;
+        }
+
+        std::lock_guard<std::mutex> job_lock(this->job_mutex);
+
+        // each worker starts with an even, contiguous share of the tasks. neighbouring tasks
+        // tend to cost about the same, but whole tiers do not, which is what stealing evens out.
+        for (index_t worker_idx = 0, worker_end = this->worker_count; worker_idx < worker_end; worker_idx += 1) {
+            this->ranges[worker_idx].Reset(task_count * worker_idx / this->worker_count,
+                                           task_count * (worker_idx + 1) / this->worker_count);
+        }
+
+        {
+            std::lock_guard<std::mutex> state_lock(this->state_mutex);
+            this->job_context = static_cast<void*>(&Run_Task);
+            this->Run_Job_Task = [](void* job_context, const index_t task_idx, const index_t worker_idx) -> void
+            {
+                Run_Task_On_Worker(*static_cast<std::remove_reference_t<Run_Task_f>*>(job_context), task_idx, worker_idx);
+            };
+            this->active_worker_count = this->worker_count - 1;
+            this->is_job_failed.store(false, std::memory_order_relaxed);
+            this->job_generation += 1;
+        }
+        this->start_condition.notify_all();
+
+        current_thread_pool = this;
+        Work_On_Job(0);
+        current_thread_pool = nullptr;
+
+        std::exception_ptr job_exception;
+        {
+            std::unique_lock<std::mutex> state_lock(this->state_mutex);
+            this->stop_condition.wait(state_lock, [this]() -> bool { return this->active_worker_count == 0; });
+            this->job_context = nullptr;
+            this->Run_Job_Task = nullptr;
+            job_exception = std::move(this->job_exception);
+            this->job_exception = nullptr;
+        }
+
+        if (job_exception) {
+            std::rethrow_exception(job_exception);
+        }
+    }
+
+    template <typename Run_Task_f>
+    void
+        thread_pool_t::Run_Task_On_Worker(Run_Task_f& Run_Task, const index_t task_idx, const index_t worker_idx)
+    {
+        if constexpr (std::is_invocable_v<Run_Task_f&, const index_t, const index_t>) {
+            Run_Task(task_idx, worker_idx);
+        } else {
+            Run_Task(task_idx);
+        }
+    }
+
+    inline void
+        thread_pool_t::Work(const index_t worker_idx)
+        noexcept
+    {
+        current_thread_pool = this;
+
+        count_t seen_generation = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> state_lock(this->state_mutex);
+                this->start_condition.wait(
+                    state_lock,
+                    [this, seen_generation]() -> bool { return this->is_stopping || this->job_generation != seen_generation; }
+                );
+                if (this->is_stopping) {
+                    return;
+                }
+                seen_generation = this->job_generation;
+            }
+
+            Work_On_Job(worker_idx);
+
+            bool is_last = false;
+            {
+                std::lock_guard<std::mutex> state_lock(this->state_mutex);
+                this->active_worker_count -= 1;
+                is_last = this->active_worker_count == 0;
+            }
+            if (is_last) {
+                this->stop_condition.notify_all();
+            }
+        }
+    }
+
+    inline void
+        thread_pool_t::Work_On_Job(const index_t worker_idx)
+        noexcept
+    {
+        // once a task has thrown, the job has failed, and so the tasks left are only taken to empty the ranges.
+        auto Run_Job_Task = [this, worker_idx](const index_t task_idx) -> void
+        {
+            if (!this->is_job_failed.load(std::memory_order_relaxed)) {
+                try {
+                    this->Run_Job_Task(this->job_context, task_idx, worker_idx);
+                } catch (...) {
+                    std::lock_guard<std::mutex> state_lock(this->state_mutex);
+                    if (!this->job_exception) {
+                        this->job_exception = std::current_exception();
+                    }
+                    this->is_job_failed.store(true, std::memory_order_relaxed);
+                }
+            }
+        };
+
+        task_range_t& own_range = this->ranges[worker_idx];
+        index_t task_idx;
+        while (true) {
+            if (own_range.Take(task_idx)) {
+                Run_Job_Task(task_idx);
+                continue;
+            }
+
+            // when we find every other range empty there may still be tasks in flight between a victim and a thief,
+            // but the thief will run those itself, and so we can stop.
+            bool did_steal = false;
+            for (index_t offset = 1, offset_end = this->worker_count; offset < offset_end && !did_steal; offset += 1) {
+                did_steal = own_range.Steal(this->ranges[(worker_idx + offset) % this->worker_count], task_idx);
+            }
+            if (did_steal) {
+                Run_Job_Task(task_idx);
+            } else {
+                break;
+            }
+        }
+    }
+
+    inline void
+        thread_pool_t::Pin(std::jthread& thread, const index_t worker_idx)
+        noexcept
+    {
+        // pinning is only a hint, and so a platform that can't do it simply leaves the thread where it is.
+        const count_t core_count = std::max(std::thread::hardware_concurrency(), 1u);
+        const index_t core_idx = worker_idx % core_count;
+#if defined(_WIN32)
+        SetThreadAffinityMask(thread.native_handle(), DWORD_PTR(1) << (core_idx % (sizeof(DWORD_PTR) * CHAR_BIT)));
+#elif defined(__linux__)
+        cpu_set_t cpu_set;
+        CPU_ZERO(&cpu_set);
+        CPU_SET(core_idx, &cpu_set);
+        pthread_setaffinity_np(thread.native_handle(), sizeof(cpu_set), &cpu_set);
+#else
+        static_cast<void>(thread);
+        static_cast<void>(core_idx);
+#endif
+    }
+
+}
+
+namespace musical_calculator {
+
+    template <typename result_t>
+    task_results_t<result_t>::task_results_t(const count_t worker_count, const count_t task_count, const count_t result_count) :
+        worker_results(worker_count),
+        task_spans(task_count, span_t{ 0, 0, 0 })
+    {
+        assert(worker_count > 0);
+
+        // when the results of the whole job are known, each worker starts with room for its share of them.
+        for (index_t worker_idx = 0, worker_end = worker_count; worker_idx < worker_end; worker_idx += 1) {
+            this->worker_results[worker_idx].reserve(result_count / worker_count);
+        }
+    }
+
+    template <typename result_t>
+    void
+        task_results_t<result_t>::Add(const index_t         task_idx,
+                                      const index_t         worker_idx,
+                                      const result_t* const results,
+                                      const count_t         result_count)
+    {
+        assert(task_idx < this->task_spans.size());
+        assert(worker_idx < this->worker_results.size());
+
+        std::vector<result_t>& worker_results = this->worker_results[worker_idx];
+        this->task_spans[task_idx] = span_t{ worker_idx, worker_results.size(), result_count };
+        worker_results.insert(worker_results.end(), results, results + result_count);
+    }
+
+    template <typename result_t>
+    count_t
+        task_results_t<result_t>::Result_Count(const index_t task_idx)
+        noexcept
+    {
+        assert(task_idx < this->task_spans.size());
+
+        return this->task_spans[task_idx].count;
+    }
+
+    template <typename result_t>
+    const result_t*
+        task_results_t<result_t>::Results(const index_t task_idx)
+        noexcept
+    {
+        assert(task_idx < this->task_spans.size());
+
+        const span_t& span = this->task_spans[task_idx];
+
+        return this->worker_results[span.worker_idx].data() + span.offset;
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline step_tracker_t::step_tracker_t(const mask_t mask, const count_t chromatic_note_count) noexcept :
+        chromatic_note_count(chromatic_note_count),
+        mask(mask),
+        smallest_step(chromatic_note_count),
+        step_counts()
+    {
+        assert(mask & 1);
+        assert(chromatic_note_count > 0);
+        assert(chromatic_note_count <= MAX_CHROMATIC_NOTE_COUNT);
+
+        // each note's step reaches up to the next note, and the last note's step wraps around to the 1 above it.
+        for (mask_t notes = mask; notes != 0; notes &= notes - 1) {
+            const index_t bit_idx = static_cast<index_t>(std::countr_zero(notes));
+            const mask_t next_notes = notes & (notes - 1);
+            const index_t next_bit_idx = next_notes ? static_cast<index_t>(std::countr_zero(next_notes)) : chromatic_note_count;
+            const count_t step = next_bit_idx - bit_idx;
+            this->step_counts[step] += 1;
+            this->smallest_step = std::min(this->smallest_step, step);
+        }
+    }
+
+    inline void
+        step_tracker_t::Add_Note(const index_t bit_idx)
+        noexcept
+    {
+        assert(bit_idx > 0);
+        assert(bit_idx < this->chromatic_note_count);
+        assert((this->mask & (mask_t(1) << bit_idx)) == 0);
+
+        // the step from the note below to the note above is split in two, both of which are smaller than it,
+        // and so if either is smaller than the smallest step, it's the new smallest step.
+        const mask_t lower_notes = this->mask & ((mask_t(1) << bit_idx) - 1);
+        const mask_t upper_notes = this->mask & ~((mask_t(2) << bit_idx) - 1);
+        const index_t lower_bit_idx = static_cast<index_t>(std::bit_width(lower_notes)) - 1;
+        const index_t upper_bit_idx = upper_notes ? static_cast<index_t>(std::countr_zero(upper_notes)) : this->chromatic_note_count;
+        this->step_counts[upper_bit_idx - lower_bit_idx] -= 1;
+        this->step_counts[bit_idx - lower_bit_idx] += 1;
+        this->step_counts[upper_bit_idx - bit_idx] += 1;
+        this->smallest_step = std::min(this->smallest_step, std::min(bit_idx - lower_bit_idx, upper_bit_idx - bit_idx));
+        this->mask |= mask_t(1) << bit_idx;
+    }
+
+    inline void
+        step_tracker_t::Remove_Note(const index_t bit_idx)
+        noexcept
+    {
+        assert(bit_idx > 0);
+        assert(bit_idx < this->chromatic_note_count);
+        assert((this->mask & (mask_t(1) << bit_idx)) != 0);
+
+        // the steps on either side of the note are joined into one. when that leaves no step of the smallest size,
+        // the next smallest is found by looking up from it, which is never further than the joined step.
+        const mask_t lower_notes = this->mask & ((mask_t(1) << bit_idx) - 1);
+        const mask_t upper_notes = this->mask & ~((mask_t(2) << bit_idx) - 1);
+        const index_t lower_bit_idx = static_cast<index_t>(std::bit_width(lower_notes)) - 1;
+        const index_t upper_bit_idx = upper_notes ? static_cast<index_t>(std::countr_zero(upper_notes)) : this->chromatic_note_count;
+        this->step_counts[bit_idx - lower_bit_idx] -= 1;
+        this->step_counts[upper_bit_idx - bit_idx] -= 1;
+        this->step_counts[upper_bit_idx - lower_bit_idx] += 1;
+        while (this->step_counts[this->smallest_step] == 0) {
+            this->smallest_step += 1;
+        }
+        this->mask &= ~(mask_t(1) << bit_idx);
+    }
+
+    inline bool
+        step_tracker_t::Is_Scale()
+        noexcept
+    {
+        // a mode of one note has one step, the whole chromatic, and is always its own scale.
+        if (this->smallest_step == this->chromatic_note_count) {
+            return true;
+        }
+
+        // the notes whose steps are the smallest step are those that have a note that far above them, and there is
+        // never a note in between. the mode has to start with one, and only the revolutions that start with one,
+        // which are to those notes, are compared with it. every other revolution starts with a larger step.
+        const mask_t smallest_step_notes =
+            this->mask & Revolve_Mask(this->mask, this->smallest_step, this->chromatic_note_count);
+        if ((smallest_step_notes & 1) == 0) {
+            return false;
+        }
+        for (mask_t notes = smallest_step_notes & (smallest_step_notes - 1); notes != 0; notes &= notes - 1) {
+            const index_t distance = static_cast<index_t>(std::countr_zero(notes));
+            if (Mask_Precedes(Revolve_Mask(this->mask, distance, this->chromatic_note_count), this->mask)) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+}
+
+namespace musical_calculator {
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    template <typename Write_Mode_f>
+    void
+        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Generate_Modes(const count_t mode_note_count, Write_Mode_f&& Write_Mode)
+    {
+        const note_t prefix[1] = { 1 };
+        Generate_Modes(prefix, 1, mode_note_count, std::forward<Write_Mode_f>(Write_Mode));
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    template <typename Write_Mode_f>
+    void
+        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Generate_Modes(const note_t* const prefix,
+                                                            const count_t       prefix_note_count,
+                                                            const count_t       mode_note_count,
+                                                            Write_Mode_f&&      Write_Mode)
+    {
+        assert(prefix_note_count > 0);
+        assert(prefix[0] == 1);
+        assert(mode_note_count > 0);
+        assert(mode_note_count >= prefix_note_count);
+        assert(mode_note_count <= CHROMATIC_NOTE_COUNT_p);
+
+        note_t mode_cache[MAX_MASK_NOTE_COUNT];
+
+        // the first mode is simply all the possible notes that can be taken
+        // from the chromatic scale without any skips after the prefix, up to the mode_note_count.
+        for (index_t idx = 0, end = prefix_note_count; idx < end; idx += 1) {
+            mode_cache[idx] = prefix[idx];
+        }
+        for (index_t idx = prefix_note_count, end = mode_note_count; idx < end; idx += 1) {
+            mode_cache[idx] = mode_cache[idx - 1] + 1;
+        }
+        Write_Mode(static_cast<const note_t*>(mode_cache));
+
+        // we never change the places of the prefix, so if that's all there is, we go ahead and return.
+        if (mode_note_count > prefix_note_count) {
+            // we can now proceed to mutate the mode by incrementing each place
+            // from the least significant digit to the most significant digit.
+            // we do not increment a place past the value of the lesser place to its
+            // right, thus we end up with combinations instead of permutations.
+            const index_t last_prefix_idx = prefix_note_count - 1;
+            while (true) {
+                // get the least significant digit iterations first,
+                // because we can't check a lesser place. Therefore it
+                // can allow upto the total number of notes possible.
+                while (mode_cache[mode_note_count - 1] + 1 <= CHROMATIC_NOTE_COUNT_p) {
+                    mode_cache[mode_note_count - 1] += 1;
+                    Write_Mode(static_cast<const note_t*>(mode_cache));
+                }
+
+                // we need to find a greater place that can be incremented.
+                // if it doesn't exist, then we are finished. we don't consider
+                // the places of the prefix, which includes idx 0, because we're
+                // only working with the one key, and so it can never be more than 1,
+                // and is thus never incrementable.
+                index_t next_idx = 0;
+                bool found_next_idx = false;
+                for (index_t idx = mode_note_count - 2; idx > last_prefix_idx; idx -= 1) {
+                    if (mode_cache[idx] + 1 < mode_cache[idx + 1]) {
+                        next_idx = idx;
+                        found_next_idx = true;
+
+                        break;
+                    }
+                }
+
+                // if we did find it, we increment the place by one and reset
+                // the lesser places for another iteration of while(true).
+                if (found_next_idx) {
+                    mode_cache[next_idx] += 1;
+                    for (index_t idx = next_idx + 1, end = mode_note_count; idx < end; idx += 1) {
+                        mode_cache[idx] = mode_cache[idx - 1] + 1;
+                    }
+                    Write_Mode(static_cast<const note_t*>(mode_cache));
+
+                    continue;
+                } else {
+                    break;
+                }
+            }
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    std::vector<mode_chunk_t>
+        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Mode_Chunks(const count_t mode_note_count, const count_t max_chunk_mode_count)
+    {
+        assert(mode_note_count > 0);
+        assert(mode_note_count <= CHROMATIC_NOTE_COUNT_p);
+        assert(max_chunk_mode_count > 0);
+
+        // a chunk that is too big is split by each note that can come after its prefix. the modes
+        // that begin with (prefix, note) number ((chromatic_note_count - note) choose (the notes left after it)).
+        std::vector<mode_chunk_t> chunks;
+        auto Split = [&chunks, mode_note_count, max_chunk_mode_count](const mode_chunk_t& chunk, auto& Split) -> void
+        {
+            if (chunk.mode_count <= max_chunk_mode_count || chunk.prefix_note_count == mode_note_count) {
+                chunks.push_back(chunk);
+            } else {
+                const count_t remaining_note_count = mode_note_count - chunk.prefix_note_count - 1;
+                mode_chunk_t child = chunk;
+                child.prefix_note_count = chunk.prefix_note_count + 1;
+                for (note_t note = chunk.prefix[chunk.prefix_note_count - 1] + 1, last_note = CHROMATIC_NOTE_COUNT_p - remaining_note_count;
+                     note <= last_note;
+                     note += 1) {
+                    child.prefix[chunk.prefix_note_count] = note;
+                    child.mode_count = CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - note][remaining_note_count];
+                    Split(child, Split);
+                    child.first_mode_idx += child.mode_count;
+                }
+            }
+        };
+
+        Split(Tier_Chunk(mode_note_count), Split);
+
+        return chunks;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    mode_chunk_t
+        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Tier_Chunk(const count_t mode_note_count)
+        noexcept
+    {
+        assert(mode_note_count > 0);
+        assert(mode_note_count <= CHROMATIC_NOTE_COUNT_p);
+
+        // every mode begins with the first note, and so that's the prefix of the whole tier.
+        mode_chunk_t tier;
+        tier.prefix[0] = 1;
+        tier.prefix_note_count = 1;
+        tier.first_mode_idx = 0;
+        tier.mode_count = CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][mode_note_count - 1];
+
+        return tier;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Generate_Chunk(note_t* notes, const mode_chunk_t& chunk, const count_t mode_note_count)
+    {
+        notes += chunk.first_mode_idx * mode_note_count;
+        Generate_Modes(
+            chunk.prefix,
+            chunk.prefix_note_count,
+            mode_note_count,
+            [&notes, mode_note_count](const note_t* const mode) -> void
+            {
+                for (index_t idx = 0, end = mode_note_count; idx < end; idx += 1) {
+                    *notes = mode[idx];
+                    notes += 1;
+                }
+            }
+        );
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Generate_Chunk(mask_t* masks, const mode_chunk_t& chunk, const count_t mode_note_count)
+    {
+        masks += chunk.first_mode_idx;
+        Generate_Modes(
+            chunk.prefix,
+            chunk.prefix_note_count,
+            mode_note_count,
+            [&masks, mode_note_count](const note_t* const mode) -> void
+            {
+                *masks = Notes_Mask(mode, mode_note_count);
+                masks += 1;
+            }
+        );
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    template <typename Write_Mode_f>
+    void
+        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Generate_Revolving_Modes(const mode_chunk_t&   chunk,
+                                                                      const count_t         mode_note_count,
+                                                                      Write_Mode_f&&        Write_Mode)
+    {
+        assert(chunk.prefix_note_count > 0);
+        assert(chunk.prefix[0] == 1);
+        assert(mode_note_count >= chunk.prefix_note_count);
+        assert(mode_note_count <= CHROMATIC_NOTE_COUNT_p);
+
+        // the modes of the chunk are its prefix with every combination of choice_count of the notes above it,
+        // which are walked with Knuth's revolving door, algorithm R in 7.2.1.3. each combination is of elements
+        // counted from 0, and element e is the note at bit (first_bit_idx + e). combination[0] is unused and
+        // combination[choice_count + 1] is always element_count, so that every place has a neighbor on either side.
+        const index_t first_bit_idx = chunk.prefix[chunk.prefix_note_count - 1];
+        const count_t element_count = CHROMATIC_NOTE_COUNT_p - first_bit_idx;
+        const count_t choice_count = mode_note_count - chunk.prefix_note_count;
+
+        index_t combination[MAX_MASK_NOTE_COUNT + 2];
+        mask_t mask = Notes_Mask(chunk.prefix, chunk.prefix_note_count);
+        for (index_t idx = 1, end = choice_count; idx <= end; idx += 1) {
+            combination[idx] = idx - 1;
+            mask |= mask_t(1) << (first_bit_idx + idx - 1);
+        }
+        combination[choice_count + 1] = element_count;
+        Write_Mode(mask, mask_t(0), mask_t(0));
+
+        auto Swap = [&mask, &Write_Mode, first_bit_idx](const index_t removed_element, const index_t added_element) -> void
+        {
+            const mask_t removed_note = mask_t(1) << (first_bit_idx + removed_element);
+            const mask_t added_note = mask_t(1) << (first_bit_idx + added_element);
+            mask ^= removed_note | added_note;
+            Write_Mode(mask, removed_note, added_note);
+        };
+
+        if (choice_count == 0) {
+            return;
+        }
+
+        while (true) {
+            // the easy case moves the lowest element up when choice_count is odd and down when it's even.
+            index_t idx = 2;
+            bool is_increasing = false;
+            if (choice_count % 2 == 1) {
+                if (combination[1] + 1 < combination[2]) {
+                    combination[1] += 1;
+                    Swap(combination[1] - 1, combination[1]);
+                    continue;
+                }
+            } else {
+                if (combination[1] > 0) {
+                    combination[1] -= 1;
+                    Swap(combination[1] + 1, combination[1]);
+                    continue;
+                }
+                is_increasing = true;
+            }
+
+            // otherwise the next place that can be decreased or increased, alternating between the two, is moved.
+            bool is_swapped = false;
+            while (idx <= choice_count && !is_swapped) {
+                if (!is_increasing) {
+                    if (combination[idx] >= idx) {
+                        const index_t removed_element = combination[idx];
+                        combination[idx] = combination[idx - 1];
+                        combination[idx - 1] = idx - 2;
+                        Swap(removed_element, idx - 2);
+                        is_swapped = true;
+                    } else {
+                        idx += 1;
+                        is_increasing = true;
+                    }
+                } else {
+                    if (combination[idx] + 1 < combination[idx + 1]) {
+                        const index_t removed_element = combination[idx - 1];
+                        combination[idx - 1] = combination[idx];
+                        combination[idx] += 1;
+                        Swap(removed_element, combination[idx]);
+                        is_swapped = true;
+                    } else {
+                        idx += 1;
+                        is_increasing = false;
+                    }
+                }
+            }
+            if (!is_swapped) {
+                break;
+            }
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    mode_tier_t<CHROMATIC_NOTE_COUNT_p>::mode_tier_t() noexcept :
+        notes(nullptr),
+        masks(nullptr)
+    {
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    mode_tier_t<CHROMATIC_NOTE_COUNT_p>::mode_tier_t(note_t* notes, const count_t mode_note_count) noexcept :
+        notes(notes),
+        masks(nullptr)
+    {
+        assert(this->notes);
+
+        Generate_Chunk(notes, Tier_Chunk(mode_note_count), mode_note_count);
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    mode_tier_t<CHROMATIC_NOTE_COUNT_p>::mode_tier_t(mask_t* masks, const count_t mode_note_count) noexcept :
+        notes(nullptr),
+        masks(masks)
+    {
+        assert(this->masks);
+
+        Generate_Chunk(masks, Tier_Chunk(mode_note_count), mode_note_count);
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    mode_t
+        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Mode(const index_t mode_idx, const count_t mode_note_count)
+        noexcept
+    {
+        if (this->notes) {
+            return mode_t(this->notes + (mode_idx * mode_note_count), mode_note_count);
+        } else {
+            assert(this->masks);
+
+            return mode_t(this->masks[mode_idx]);
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Print_Modes(count_t mode_count, count_t mode_note_count)
+        noexcept
+    {
+        writer_t writer(std::cout);
+        for (index_t idx = 0, end = mode_count; idx < end; idx += 1) {
+            writer.Write_Mode(Mode(idx, mode_note_count));
+        }
+    }
+
+}
+
+namespace musical_calculator {
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Scale_Modes(const note_t* scale,
+                                                          const count_t scale_note_count,
+                                                          note_t* const results)
+        noexcept
+    {
+        // the first mode is always going to be the scale (or first mode) that is passed in.
+        for (index_t idx = 0, end = scale_note_count; idx < end; idx += 1) {
+            results[idx] = scale[idx];
+        }
+
+        for (index_t previous_mode_idx = 0, previous_mode_end = scale_note_count * scale_note_count - scale_note_count;
+             previous_mode_idx < previous_mode_end;
+             previous_mode_idx += scale_note_count) {
+            const index_t this_mode_idx = previous_mode_idx + scale_note_count;
+
+            // first, we revolve the actual notes as they appear from the previous mode.
+            // then we set the last new note to the previous's first + the chromatic_note_count.
+            for (index_t note_idx = 0, note_end = scale_note_count - 1;
+                 note_idx < note_end;
+                 note_idx += 1) {
+                results[this_mode_idx + note_idx] = results[previous_mode_idx + note_idx + 1];
+            }
+            results[this_mode_idx + scale_note_count - 1] = results[previous_mode_idx + 0] + CHROMATIC_NOTE_COUNT_p;
+
+            // then for each subsequent note we add the total note count and subtract by new_first_note - 1.
+            const count_t first_note_diff = results[this_mode_idx + 0] - 1;
+            for (index_t note_idx = 0, note_end = scale_note_count;
+                 note_idx < note_end;
+                 note_idx += 1) {
+                results[this_mode_idx + note_idx] = results[this_mode_idx + note_idx] - first_note_diff;
+            }
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    count_t
+        scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Find_Scales(const mode_tier_t<CHROMATIC_NOTE_COUNT_p>&    mode_tier,
+                                                          const index_t                                 first_mode_idx,
+                                                          const count_t                                 mode_count,
+                                                          const count_t                                 mode_note_count,
+                                                          const scale_kernel_e                          scale_kernel,
+                                                          std::uint32_t* const                          results,
+                                                          scale_membership_t* const                     membership)
+        noexcept
+    {
+        // each scale found is written to the next result, as the index of its mode when the mode tier stores notes,
+        // and as its mask otherwise. there is never more than one scale per mode, and so results needs room for mode_count.
+        count_t scale_count = 0;
+        auto Add_Scale = [&](const index_t mode_idx, const mask_t mask) -> void
+        {
+            results[scale_count] = mode_tier.notes ? static_cast<std::uint32_t>(mode_idx) : mask;
+            scale_count += 1;
+            if (membership) {
+                membership->Record_Scale(mask, mode_idx, CHROMATIC_NOTE_COUNT_p);
+            }
+        };
+
+        // We iterate over the modes to find the first occurence of each unique scale.
+        // We can do this extremely cheaply by utilizing the fact that we generate the modes in numerical order.
+        // It is always the case then that the first occurence of a unique scale will be the mode in a set that equates
+        // to the lowest numerical number. Therefore if we see a mode that is numerically bigger than it deriviations
+        // we know we have already added that mode's scale to the array. We completely avoid lookups doing this,
+        // and thus achieve a high level of efficiency and performance while working with the massive number of
+        // modes that exist in the larger chromatic scales and their tiers of modes.
+        auto Has_Mode_Scale = [](const note_t*  mode,
+                                 const count_t  mode_note_count,
+                                 note_t* const  note_cache) -> bool
+        {
+            // we cache all the possible deriviations or revolutions of the mode.
+            // notice that we do not allocate and deallocate memory, which would be very non-performant
+            Scale_Modes(mode, mode_note_count, note_cache);
+
+            // if the first mode is numerically smaller than its deriviations, it's the first occurence of a unique scale
+            for (index_t mode_idx = mode_note_count, mode_end = mode_note_count * mode_note_count;
+                 mode_idx < mode_end;
+                 mode_idx += mode_note_count) {
+                for (index_t note_idx = 1, note_end = mode_note_count;
+                     note_idx < note_end;
+                     note_idx += 1) {
+                    if (note_cache[note_idx] > note_cache[mode_idx + note_idx]) {
+                        return true;
+                    } else if (note_cache[note_idx] < note_cache[mode_idx + note_idx]) {
+                        break;
+                    }
+                }
+            }
+
+            return false;
+        };
+
+        // the mask kernel decides the same thing by comparing whole revolutions of the mask at once,
+        // and so needs neither the cache nor the notes themselves. the modes are classified a block
+        // at a time, several to a vector register, and those that are scales are then kept in order.
+        // the revolving door kernel only differs when it generates the modes, and so here it does the same.
+        if (scale_kernel != scale_kernel_e::SCALE_MODES) {
+            mask_t block_masks[CLASSIFY_BLOCK_MODE_COUNT];
+            std::uint8_t block_is_scales[CLASSIFY_BLOCK_MODE_COUNT];
+            for (index_t block_idx = first_mode_idx, block_end = first_mode_idx + mode_count;
+                 block_idx < block_end;
+                 block_idx += CLASSIFY_BLOCK_MODE_COUNT) {
+                const count_t block_mode_count = std::min(CLASSIFY_BLOCK_MODE_COUNT, block_end - block_idx);
+                const mask_t* block = block_masks;
+                if (mode_tier.notes) {
+                    for (index_t idx = 0; idx < block_mode_count; idx += 1) {
+                        block_masks[idx] = Notes_Mask(mode_tier.notes + (block_idx + idx) * mode_note_count, mode_note_count);
+                    }
+                } else {
+                    assert(mode_tier.masks);
+                    block = mode_tier.masks + block_idx;
+                }
+
+                Classify_Scale_Masks(block, block_mode_count, CHROMATIC_NOTE_COUNT_p, block_is_scales);
+                for (index_t idx = 0; idx < block_mode_count; idx += 1) {
+                    if (block_is_scales[idx]) {
+                        Add_Scale(block_idx + idx, block[idx]);
+                    }
+                }
+            }
+
+            return scale_count;
+        }
+
+        // the cache holds every revolution of one mode, and is small enough to live on the stack.
+        note_t note_cache[CHROMATIC_NOTE_COUNT_p * CHROMATIC_NOTE_COUNT_p];
+        if (mode_tier.notes) {
+            for (index_t mode_idx = first_mode_idx, mode_end = first_mode_idx + mode_count;
+                 mode_idx < mode_end;
+                 mode_idx += 1) {
+                const note_t* const mode = mode_tier.notes + mode_idx * mode_note_count;
+                if (!Has_Mode_Scale(mode, mode_note_count, note_cache)) {
+                    Add_Scale(mode_idx, Notes_Mask(mode, mode_note_count));
+                }
+            }
+        } else {
+            assert(mode_tier.masks);
+
+            // the masks are decoded one at a time into a small buffer, so that we never need the notes of more than one mode.
+            note_t mode_buffer[MAX_MASK_NOTE_COUNT];
+            for (index_t mode_idx = first_mode_idx, mode_end = first_mode_idx + mode_count;
+                 mode_idx < mode_end;
+                 mode_idx += 1) {
+                const mask_t mask = mode_tier.masks[mode_idx];
+                Mask_Notes(mask, mode_buffer);
+                if (!Has_Mode_Scale(mode_buffer, mode_note_count, note_cache)) {
+                    Add_Scale(mode_idx, mask);
+                }
+            }
+        }
+
+        return scale_count;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    count_t
+        scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Find_Revolving_Scales(note_t* const               notes,
+                                                                    mask_t* const               masks,
+                                                                    const mode_chunk_t&         chunk,
+                                                                    const count_t               mode_note_count,
+                                                                    std::uint32_t* const        results,
+                                                                    scale_membership_t* const   membership)
+        noexcept
+    {
+        assert(notes || masks);
+
+        // the modes come out of the revolving door in no numerical order, and so each is written to its place in
+        // the tier by its rank, and so is its result, which is left empty when it isn't a scale. the results are
+        // then packed down in order, which leaves the scales where Find_Scales would have put them.
+        constexpr std::uint32_t EMPTY_RESULT = ~std::uint32_t(0);
+
+        step_tracker_t step_tracker(1, CHROMATIC_NOTE_COUNT_p);
+        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Generate_Revolving_Modes(
+            chunk,
+            mode_note_count,
+            [&](const mask_t mask, const mask_t removed_note, const mask_t added_note) -> void
+            {
+                if (removed_note) {
+                    step_tracker.Remove_Note(static_cast<index_t>(std::countr_zero(removed_note)));
+                    step_tracker.Add_Note(static_cast<index_t>(std::countr_zero(added_note)));
+                } else {
+                    step_tracker = step_tracker_t(mask, CHROMATIC_NOTE_COUNT_p);
+                }
+                assert(step_tracker.mask == mask);
+
+                const index_t mode_idx = Rank_Mask(mask, CHROMATIC_NOTE_COUNT_p);
+                if (notes) {
+                    Mask_Notes(mask, notes + mode_idx * mode_note_count);
+                } else {
+                    masks[mode_idx] = mask;
+                }
+
+                if (step_tracker.Is_Scale()) {
+                    results[mode_idx - chunk.first_mode_idx] = notes ? static_cast<std::uint32_t>(mode_idx) : mask;
+                    if (membership) {
+                        membership->Record_Scale(mask, mode_idx, CHROMATIC_NOTE_COUNT_p);
+                    }
+                } else {
+                    results[mode_idx - chunk.first_mode_idx] = EMPTY_RESULT;
+                }
+            }
+        );
+
+        count_t scale_count = 0;
+        for (index_t idx = 0, end = chunk.mode_count; idx < end; idx += 1) {
+            if (results[idx] != EMPTY_RESULT) {
+                results[scale_count] = results[idx];
+                scale_count += 1;
+            }
+        }
+
+        return scale_count;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_tier_t<CHROMATIC_NOTE_COUNT_p>::scale_tier_t() noexcept :
+        entries(),
+        viewed_entries(nullptr),
+        viewed_entry_count(0),
+        mode_notes(nullptr)
+    {
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_tier_t<CHROMATIC_NOTE_COUNT_p>::scale_tier_t(const std::uint32_t* viewed_entries,
+                                                       const count_t        viewed_entry_count,
+                                                       const note_t*        mode_notes) noexcept :
+        entries(),
+        viewed_entries(viewed_entries),
+        viewed_entry_count(viewed_entry_count),
+        mode_notes(mode_notes)
+    {
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_tier_t<CHROMATIC_NOTE_COUNT_p>::scale_tier_t(const mode_tier_t<CHROMATIC_NOTE_COUNT_p>&   mode_tier,
+                                                       const count_t                                mode_count,
+                                                       const count_t                                mode_note_count,
+                                                       const scale_kernel_e                         scale_kernel) :
+        entries(),
+        viewed_entries(nullptr),
+        viewed_entry_count(0),
+        mode_notes(mode_tier.notes)
+    {
+        // the scales of a whole tier are counted up front, and so take exactly the room they need.
+        // part of a tier can have as many scales as modes, and gives back whatever it doesn't use.
+        const bool is_whole_tier = mode_count == CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][mode_note_count - 1];
+        this->entries.resize(is_whole_tier ? Count_Tier_Scales(CHROMATIC_NOTE_COUNT_p, mode_note_count).Count() : mode_count);
+
+        const count_t scale_count = Find_Scales(mode_tier, 0, mode_count, mode_note_count, scale_kernel, this->entries.data());
+        assert(!is_whole_tier || scale_count == this->entries.size());
+        this->entries.resize(scale_count);
+        this->entries.shrink_to_fit();
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_tier_t<CHROMATIC_NOTE_COUNT_p>::scale_tier_t(const count_t scale_note_count) :
+        entries(),
+        viewed_entries(nullptr),
+        viewed_entry_count(0),
+        mode_notes(nullptr)
+    {
+        this->entries.reserve(Count_Tier_Scales(CHROMATIC_NOTE_COUNT_p, scale_note_count).Count());
+
+        scale_generator_t generator(CHROMATIC_NOTE_COUNT_p, scale_note_count);
+        for (mask_t mask; generator.Next(mask);) {
+            this->entries.push_back(mask);
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    count_t
+        scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Scale_Count()
+        noexcept
+    {
+        return this->viewed_entries ? this->viewed_entry_count : this->entries.size();
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    const std::uint32_t*
+        scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Entries()
+        noexcept
+    {
+        return this->viewed_entries ? this->viewed_entries : this->entries.data();
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_t
+        scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Scale(const index_t scale_idx, const count_t scale_note_count)
+        noexcept
+    {
+        assert(scale_idx < Scale_Count());
+
+        const std::uint32_t entry = Entries()[scale_idx];
+        if (this->mode_notes) {
+            return scale_t(this->mode_notes + entry * scale_note_count, scale_note_count);
+        } else {
+            return scale_t(entry);
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    std::vector<mask_t>
+        scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Scale_Masks(const count_t scale_note_count)
+    {
+        // a tier that stores its scales as notes is packed into masks.
+        std::vector<mask_t> scales(Scale_Count());
+        for (index_t idx = 0, end = scales.size(); idx < end; idx += 1) {
+            scales[idx] = Scale(idx, scale_note_count).Mask();
+        }
+
+        return scales;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Print_Scales(const count_t scale_note_count)
+        noexcept
+    {
+        writer_t writer(std::cout);
+        for (index_t idx = 0, end = Scale_Count(); idx < end; idx += 1) {
+            writer.Write_Mode(Scale(idx, scale_note_count));
+        }
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline scale_membership_t::scale_membership_t() noexcept :
+        mode_scale_idxs(),
+        mode_rotations(),
+        scale_periods()
+    {
+    }
+
+    inline scale_membership_t::scale_membership_t(const count_t mode_count) :
+        mode_scale_idxs(mode_count, 0),
+        mode_rotations(mode_count, 0),
+        scale_periods()
+    {
+        static_assert(MAX_CHROMATIC_NOTE_COUNT <= UINT8_MAX);
+    }
+
+    inline void
+        scale_membership_t::Record_Scale(const mask_t scale_mask, const index_t scale_mode_idx, const count_t chromatic_note_count)
+        noexcept
+    {
+        assert(scale_mode_idx < Mode_Count());
+
+        // every mode of the scale is written by whichever chunk found the scale, and no other chunk shares any of them.
+        // we go through the rotations backwards so that when a scale repeats itself, the smallest rotation is kept,
+        // and the rotations that give back the scale itself are left alone, so that the scale keeps rotation 0.
+        note_t scale_notes[MAX_MASK_NOTE_COUNT];
+        Mask_Notes(scale_mask, scale_notes);
+        const count_t scale_note_count = Mask_Note_Count(scale_mask);
+        count_t period = scale_note_count;
+        for (index_t rotation = scale_note_count; rotation > 1;) {
+            rotation -= 1;
+            const mask_t mode_mask = Revolve_Mask(scale_mask, scale_notes[rotation] - 1, chromatic_note_count);
+            if (mode_mask == scale_mask) {
+                period = rotation;
+            } else {
+                const index_t mode_idx = Rank_Mask(mode_mask, chromatic_note_count);
+                this->mode_scale_idxs[mode_idx] = static_cast<std::uint32_t>(scale_mode_idx);
+                this->mode_rotations[mode_idx] = static_cast<std::uint8_t>(rotation);
+            }
+        }
+
+        // until it's resolved, the scale's own entry holds its period instead, as it would otherwise only point to itself.
+        this->mode_scale_idxs[scale_mode_idx] = static_cast<std::uint32_t>(period);
+        this->mode_rotations[scale_mode_idx] = 0;
+    }
+
+    inline void
+        scale_membership_t::Resolve(const count_t scale_count)
+    {
+        // the scales are met in the same order they were found in, and each one before any of its other modes,
+        // so that every other mode can take its scale index from the scale's entry, which is already resolved.
+        this->scale_periods.clear();
+        this->scale_periods.reserve(scale_count);
+        for (index_t mode_idx = 0, mode_end = Mode_Count(); mode_idx < mode_end; mode_idx += 1) {
+            if (this->mode_rotations[mode_idx] == 0) {
+                this->scale_periods.push_back(static_cast<std::uint8_t>(this->mode_scale_idxs[mode_idx]));
+                this->mode_scale_idxs[mode_idx] = static_cast<std::uint32_t>(this->scale_periods.size() - 1);
+            } else {
+                assert(this->mode_scale_idxs[mode_idx] < mode_idx);
+                this->mode_scale_idxs[mode_idx] = this->mode_scale_idxs[this->mode_scale_idxs[mode_idx]];
+            }
+        }
+        assert(this->scale_periods.size() == scale_count);
+    }
+
+    inline count_t
+        scale_membership_t::Mode_Count()
+        noexcept
+    {
+        return this->mode_scale_idxs.size();
+    }
+
+    inline count_t
+        scale_membership_t::Scale_Count()
+        noexcept
+    {
+        return this->scale_periods.size();
+    }
+
+    inline index_t
+        scale_membership_t::Mode_Scale_Index(const index_t mode_idx)
+        noexcept
+    {
+        assert(mode_idx < Mode_Count());
+
+        return this->mode_scale_idxs[mode_idx];
+    }
+
+    inline index_t
+        scale_membership_t::Mode_Rotation(const index_t mode_idx)
+        noexcept
+    {
+        assert(mode_idx < Mode_Count());
+
+        return this->mode_rotations[mode_idx];
+    }
+
+    inline count_t
+        scale_membership_t::Scale_Period(const index_t scale_idx)
+        noexcept
+    {
+        assert(scale_idx < Scale_Count());
+
+        return this->scale_periods[scale_idx];
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline bracelet_tier_t::bracelet_tier_t() noexcept :
+        chromatic_note_count(0),
+        bracelets(),
+        is_chirals(),
+        scale_bracelet_idxs()
+    {
+    }
+
+    inline bracelet_tier_t::bracelet_tier_t(const mask_t* const scales, const count_t scale_count, const count_t chromatic_note_count) :
+        chromatic_note_count(chromatic_note_count),
+        bracelets(),
+        is_chirals(),
+        scale_bracelet_idxs(scale_count, 0)
+    {
+        assert(scales != nullptr || scale_count == 0);
+
+        for (index_t scale_idx = 0; scale_idx < scale_count; scale_idx += 1) {
+            const mask_t scale = scales[scale_idx];
+            const mask_t inversion_scale = Scale_Mask(Invert_Mask(scale, chromatic_note_count), chromatic_note_count);
+            if (inversion_scale == scale || Mask_Precedes(scale, inversion_scale)) {
+                this->scale_bracelet_idxs[scale_idx] = static_cast<std::uint32_t>(this->bracelets.size());
+                this->bracelets.push_back(scale);
+                this->is_chirals.push_back(inversion_scale != scale);
+            } else {
+                // the inversion's scale comes first, and so it has already started the class.
+                const mask_t* const inversion = std::lower_bound(scales, scales + scale_idx, inversion_scale, Mask_Precedes);
+                assert(inversion < scales + scale_idx && *inversion == inversion_scale);
+                this->scale_bracelet_idxs[scale_idx] = this->scale_bracelet_idxs[inversion - scales];
+            }
+        }
+    }
+
+    inline bracelet_tier_t::bracelet_tier_t(const std::vector<mask_t>& scales, const count_t chromatic_note_count) :
+        bracelet_tier_t(scales.data(), scales.size(), chromatic_note_count)
+    {
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    bracelet_tier_t::bracelet_tier_t(scale_tier_t<CHROMATIC_NOTE_COUNT_p>& scale_tier, const count_t scale_note_count) :
+        bracelet_tier_t(scale_tier.Scale_Masks(scale_note_count), CHROMATIC_NOTE_COUNT_p)
+    {
+    }
+
+    inline bracelet_tier_t::bracelet_tier_t(const count_t chromatic_note_count, const count_t scale_note_count) :
+        chromatic_note_count(chromatic_note_count),
+        bracelets(),
+        is_chirals(),
+        scale_bracelet_idxs()
+    {
+        assert(chromatic_note_count > 0);
+        assert(chromatic_note_count <= MAX_CHROMATIC_NOTE_COUNT);
+
+        bracelet_generator_t generator(chromatic_note_count, scale_note_count);
+        mask_t bracelet;
+        while (generator.Next(bracelet)) {
+            this->bracelets.push_back(bracelet);
+            this->is_chirals.push_back(generator.is_chiral);
+        }
+    }
+
+    inline count_t
+        bracelet_tier_t::Scale_Count()
+        noexcept
+    {
+        return this->scale_bracelet_idxs.size();
+    }
+
+    inline count_t
+        bracelet_tier_t::Bracelet_Count()
+        noexcept
+    {
+        return this->bracelets.size();
+    }
+
+    inline count_t
+        bracelet_tier_t::Chiral_Count()
+        noexcept
+    {
+        return static_cast<count_t>(std::count(this->is_chirals.begin(), this->is_chirals.end(), std::uint8_t(1)));
+    }
+
+    inline scale_t
+        bracelet_tier_t::Bracelet(const index_t bracelet_idx)
+        noexcept
+    {
+        assert(bracelet_idx < Bracelet_Count());
+
+        return scale_t(this->bracelets[bracelet_idx]);
+    }
+
+    inline bool
+        bracelet_tier_t::Is_Chiral(const index_t bracelet_idx)
+        noexcept
+    {
+        assert(bracelet_idx < Bracelet_Count());
+
+        return this->is_chirals[bracelet_idx];
+    }
+
+    inline index_t
+        bracelet_tier_t::Scale_Bracelet_Index(const index_t scale_idx)
+        noexcept
+    {
+        assert(scale_idx < Scale_Count());
+
+        return this->scale_bracelet_idxs[scale_idx];
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline count_t
+        scale_analytics_t::Interval_Class_Count(const count_t chromatic_note_count)
+        noexcept
+    {
+        // an interval and its complement in the chromatic are the same class.
+        return chromatic_note_count / 2;
+    }
+
+    inline scale_analytics_t::scale_analytics_t(const mask_t* const     scales,
+                                                const count_t           scale_count,
+                                                const count_t           chromatic_note_count,
+                                                thread_pool_t* const    thread_pool) :
+        scale_analytics_t(std::vector<mask_t>(scales, scales + scale_count), chromatic_note_count, thread_pool)
+    {
+    }
+
+    inline scale_analytics_t::scale_analytics_t(std::vector<mask_t>&&   scales,
+                                                const count_t           chromatic_note_count,
+                                                thread_pool_t* const    thread_pool) :
+        chromatic_note_count(chromatic_note_count),
+        scales(std::move(scales)),
+        interval_counts(Interval_Class_Count(chromatic_note_count) * this->scales.size(), 0),
+        step_counts(chromatic_note_count * this->scales.size(), 0),
+        step_maxima(this->scales.size(), 0),
+        step_minima(this->scales.size(), 0),
+        cohemitonia(this->scales.size(), 0)
+    {
+        assert(chromatic_note_count > 0);
+        assert(chromatic_note_count <= MAX_CHROMATIC_NOTE_COUNT);
+
+        Analyze(thread_pool);
+    }
+
+    inline scale_analytics_t::scale_analytics_t(chromatic_engine_t& chromatic, thread_pool_t* const thread_pool) :
+        scale_analytics_t(chromatic.Scale_Masks(), chromatic.Chromatic_Note_Count(), thread_pool)
+    {
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_analytics_t::scale_analytics_t(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic, thread_pool_t* const thread_pool) :
+        scale_analytics_t(chromatic.Scale_Masks(), CHROMATIC_NOTE_COUNT_p, thread_pool)
+    {
+    }
+
+    inline void
+        scale_analytics_t::Analyze(const index_t first_scale_idx, const count_t scale_count)
+        noexcept
+    {
+        const count_t chromatic_note_count = this->chromatic_note_count;
+        const count_t interval_class_count = Interval_Class_Count(chromatic_note_count);
+        const count_t column_scale_count = Scale_Count();
+        for (index_t scale_idx = first_scale_idx, scale_end = first_scale_idx + scale_count; scale_idx < scale_end; scale_idx += 1) {
+            const mask_t scale = this->scales[scale_idx];
+
+            // each pair of notes an interval apart leaves one bit when the scale is and-ed with its revolution by that interval.
+            // at the tritone of an even chromatic, the interval is its own complement, and so each pair leaves two bits instead.
+            for (count_t interval_class = 1; interval_class <= interval_class_count; interval_class += 1) {
+                count_t count = static_cast<count_t>(std::popcount(scale & Revolve_Mask(scale, interval_class, chromatic_note_count)));
+                if (interval_class * 2 == chromatic_note_count) {
+                    count /= 2;
+                }
+                this->interval_counts[(interval_class - 1) * column_scale_count + scale_idx] = static_cast<std::uint8_t>(count);
+            }
+
+            // the last step wraps around from the highest note to the 1 of the next octave.
+            count_t step_maximum = 0;
+            count_t step_minimum = chromatic_note_count;
+            for (mask_t notes = scale; notes != 0; notes &= notes - 1) {
+                const index_t bit = static_cast<index_t>(std::countr_zero(notes));
+                const mask_t higher_notes = notes & (notes - 1);
+                const count_t step_size = higher_notes != 0 ?
+                    static_cast<count_t>(std::countr_zero(higher_notes)) - bit :
+                    chromatic_note_count - bit;
+                this->step_counts[(step_size - 1) * column_scale_count + scale_idx] += 1;
+                step_maximum = std::max(step_maximum, step_size);
+                step_minimum = std::min(step_minimum, step_size);
+            }
+            this->step_maxima[scale_idx] = static_cast<std::uint8_t>(step_maximum);
+            this->step_minima[scale_idx] = static_cast<std::uint8_t>(step_minimum);
+
+            if (chromatic_note_count > 2) {
+                this->cohemitonia[scale_idx] = static_cast<std::uint8_t>(std::popcount(
+                    scale & Revolve_Mask(scale, 1, chromatic_note_count) & Revolve_Mask(scale, 2, chromatic_note_count)));
+            }
+        }
+    }
+
+    inline void
+        scale_analytics_t::Analyze(thread_pool_t* const thread_pool)
+    {
+        // like building a chromatic, a small number of scales are analyzed on this thread alone.
+        thread_pool_t serial_thread_pool(1);
+        thread_pool_t& chosen_thread_pool = thread_pool_t::Choose(Scale_Count(), thread_pool, serial_thread_pool);
+
+        const count_t chunk_count = (Scale_Count() + MAX_CHUNK_SCALE_COUNT - 1) / MAX_CHUNK_SCALE_COUNT;
+        chosen_thread_pool.Run_Tasks(
+            chunk_count,
+            [this](const index_t chunk_idx) -> void
+            {
+                const index_t first_scale_idx = chunk_idx * MAX_CHUNK_SCALE_COUNT;
+                Analyze(first_scale_idx, std::min(MAX_CHUNK_SCALE_COUNT, Scale_Count() - first_scale_idx));
+            }
+        );
+    }
+
+    inline count_t
+        scale_analytics_t::Scale_Count()
+        noexcept
+    {
+        return this->scales.size();
+    }
+
+    inline const std::uint8_t*
+        scale_analytics_t::Interval_Column(const count_t interval_class)
+        noexcept
+    {
+        assert(interval_class > 0 && interval_class <= Interval_Class_Count(this->chromatic_note_count));
+
+        return this->interval_counts.data() + (interval_class - 1) * Scale_Count();
+    }
+
+    inline const std::uint8_t*
+        scale_analytics_t::Step_Column(const count_t step_size)
+        noexcept
+    {
+        assert(step_size > 0 && step_size <= this->chromatic_note_count);
+
+        return this->step_counts.data() + (step_size - 1) * Scale_Count();
+    }
+
+    inline count_t
+        scale_analytics_t::Interval_Count(const index_t scale_idx, const count_t interval_class)
+        noexcept
+    {
+        assert(scale_idx < Scale_Count());
+
+        return Interval_Column(interval_class)[scale_idx];
+    }
+
+    inline count_t
+        scale_analytics_t::Step_Count(const index_t scale_idx, const count_t step_size)
+        noexcept
+    {
+        assert(scale_idx < Scale_Count());
+
+        return Step_Column(step_size)[scale_idx];
+    }
+
+    inline count_t
+        scale_analytics_t::Step_Maximum(const index_t scale_idx)
+        noexcept
+    {
+        assert(scale_idx < Scale_Count());
+
+        return this->step_maxima[scale_idx];
+    }
+
+    inline count_t
+        scale_analytics_t::Step_Minimum(const index_t scale_idx)
+        noexcept
+    {
+        assert(scale_idx < Scale_Count());
+
+        return this->step_minima[scale_idx];
+    }
+
+    inline count_t
+        scale_analytics_t::Hemitonia(const index_t scale_idx)
+        noexcept
+    {
+        assert(scale_idx < Scale_Count());
+
+        // a chromatic of one note has no semitones to count.
+        return this->chromatic_note_count > 1 ? Interval_Count(scale_idx, 1) : 0;
+    }
+
+    inline count_t
+        scale_analytics_t::Cohemitonia(const index_t scale_idx)
+        noexcept
+    {
+        assert(scale_idx < Scale_Count());
+
+        return this->cohemitonia[scale_idx];
+    }
+
+    inline void
+        scale_analytics_t::Common_Tone_Counts(const mask_t          reference,
+                                              std::uint8_t* const   results,
+                                              thread_pool_t* const  thread_pool)
+    {
+        assert((reference & ~Chromatic_Mask(this->chromatic_note_count)) == 0);
+        assert(results != nullptr || Scale_Count() == 0);
+
+        thread_pool_t serial_thread_pool(1);
+        thread_pool_t& chosen_thread_pool = thread_pool_t::Choose(Scale_Count(), thread_pool, serial_thread_pool);
+
+        const count_t chunk_count = (Scale_Count() + MAX_CHUNK_SCALE_COUNT - 1) / MAX_CHUNK_SCALE_COUNT;
+        chosen_thread_pool.Run_Tasks(
+            chunk_count,
+            [this, reference, results](const index_t chunk_idx) -> void
+            {
+                const index_t first_scale_idx = chunk_idx * MAX_CHUNK_SCALE_COUNT;
+                const index_t scale_end = std::min(first_scale_idx + MAX_CHUNK_SCALE_COUNT, Scale_Count());
+                for (index_t scale_idx = first_scale_idx; scale_idx < scale_end; scale_idx += 1) {
+                    const mask_t scale = this->scales[scale_idx];
+                    count_t common_tone_count = 0;
+                    for (index_t distance = 0; distance < this->chromatic_note_count; distance += 1) {
+                        common_tone_count = std::max(
+                            common_tone_count,
+                            static_cast<count_t>(std::popcount(Revolve_Mask(scale, distance, this->chromatic_note_count) & reference)));
+                    }
+                    results[scale_idx] = static_cast<std::uint8_t>(common_tone_count);
+                }
+            }
+        );
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline scale_index_t::scale_index_t(scale_analytics_t& analytics) :
+        chromatic_note_count(analytics.chromatic_note_count),
+        word_count((analytics.Scale_Count() + WORD_BIT_COUNT - 1) / WORD_BIT_COUNT),
+        scales(analytics.scales),
+        tier_offsets(analytics.chromatic_note_count + 1, 0),
+        interval_class_bitsets(scale_analytics_t::Interval_Class_Count(analytics.chromatic_note_count) * word_count, 0),
+        step_maximum_bitsets(analytics.chromatic_note_count * word_count, 0)
+    {
+        const count_t scale_count = Scale_Count();
+
+        // the scales are in order of their note counts, and so each tier ends where the next begins.
+        for (index_t scale_idx = 0; scale_idx < scale_count; scale_idx += 1) {
+            this->tier_offsets[Mask_Note_Count(this->scales[scale_idx])] = scale_idx + 1;
+        }
+        for (index_t tier_idx = 1, tier_end = this->tier_offsets.size(); tier_idx < tier_end; tier_idx += 1) {
+            this->tier_offsets[tier_idx] = std::max(this->tier_offsets[tier_idx], this->tier_offsets[tier_idx - 1]);
+        }
+
+        for (count_t interval_class = 1, interval_class_end = scale_analytics_t::Interval_Class_Count(this->chromatic_note_count);
+             interval_class <= interval_class_end;
+             interval_class += 1) {
+            const std::uint8_t* const column = analytics.Interval_Column(interval_class);
+            std::uint64_t* const bitset = this->interval_class_bitsets.data() + (interval_class - 1) * this->word_count;
+            for (index_t scale_idx = 0; scale_idx < scale_count; scale_idx += 1) {
+                bitset[scale_idx / WORD_BIT_COUNT] |= std::uint64_t(column[scale_idx] > 0) << (scale_idx % WORD_BIT_COUNT);
+            }
+        }
+
+        // a scale is in the bitset of its largest step, and every larger one.
+        for (index_t scale_idx = 0; scale_idx < scale_count; scale_idx += 1) {
+            for (count_t step_size = analytics.Step_Maximum(scale_idx); step_size <= this->chromatic_note_count; step_size += 1) {
+                this->step_maximum_bitsets[(step_size - 1) * this->word_count + scale_idx / WORD_BIT_COUNT] |=
+                    std::uint64_t(1) << (scale_idx % WORD_BIT_COUNT);
+            }
+        }
+    }
+
+    inline count_t
+        scale_index_t::Scale_Count()
+        noexcept
+    {
+        return this->scales.size();
+    }
+
+    inline scale_t
+        scale_index_t::Scale(const index_t scale_idx)
+        noexcept
+    {
+        assert(scale_idx < Scale_Count());
+
+        return scale_t(this->scales[scale_idx]);
+    }
+
+    inline const std::uint64_t*
+        scale_index_t::Interval_Class_Bitset(const count_t interval_class)
+        noexcept
+    {
+        assert(interval_class > 0 && interval_class <= scale_analytics_t::Interval_Class_Count(this->chromatic_note_count));
+
+        return this->interval_class_bitsets.data() + (interval_class - 1) * this->word_count;
+    }
+
+    inline const std::uint64_t*
+        scale_index_t::Step_Maximum_Bitset(const count_t step_size)
+        noexcept
+    {
+        assert(step_size > 0 && step_size <= this->chromatic_note_count);
+
+        return this->step_maximum_bitsets.data() + (step_size - 1) * this->word_count;
+    }
+
+    inline scale_query_t
+        scale_index_t::Query()
+    {
+        return scale_query_t(*this);
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline scale_query_t::iterator_t::iterator_t() noexcept :
+        query(nullptr),
+        word_idx(0),
+        word(0),
+        scale_idx(0),
+        is_done(true)
+    {
+    }
+
+    inline scale_query_t::iterator_t::iterator_t(const scale_query_t& query) noexcept :
+        query(&query),
+        word_idx(0),
+        word(query.words.empty() ? 0 : query.words[0]),
+        scale_idx(0),
+        is_done(false)
+    {
+        ++(*this);
+    }
+
+    inline index_t
+        scale_query_t::iterator_t::operator *()
+        const noexcept
+    {
+        assert(!this->is_done);
+
+        return this->scale_idx;
+    }
+
+    inline scale_query_t::iterator_t&
+        scale_query_t::iterator_t::operator ++()
+        noexcept
+    {
+        // the word holds the scales of the current word that are yet to be yielded, and empty words are skipped whole.
+        while (this->word == 0) {
+            this->word_idx += 1;
+            if (this->word_idx >= this->query->words.size()) {
+                this->is_done = true;
+                return *this;
+            }
+            this->word = this->query->words[this->word_idx];
+        }
+
+        this->scale_idx = this->word_idx * scale_index_t::WORD_BIT_COUNT + static_cast<index_t>(std::countr_zero(this->word));
+        this->word &= this->word - 1;
+
+        return *this;
+    }
+
+    inline void
+        scale_query_t::iterator_t::operator ++(int)
+        noexcept
+    {
+        ++(*this);
+    }
+
+    inline scale_query_t::scale_query_t(scale_index_t& index) :
+        index(&index),
+        words(index.word_count, ~std::uint64_t(0))
+    {
+        // the bits past the last scale are never set.
+        if (index.Scale_Count() % scale_index_t::WORD_BIT_COUNT != 0) {
+            this->words.back() = (std::uint64_t(1) << (index.Scale_Count() % scale_index_t::WORD_BIT_COUNT)) - 1;
+        }
+    }
+
+    inline scale_query_t&
+        scale_query_t::With_Note_Count(const count_t note_count)
+        & noexcept
+    {
+        return With_Note_Counts(note_count, note_count);
+    }
+
+    inline scale_query_t&
+        scale_query_t::With_Note_Counts(const count_t min_note_count, const count_t max_note_count)
+        & noexcept
+    {
+        assert(min_note_count > 0 && min_note_count <= max_note_count);
+
+        // only the scales from the first tier to the last are kept, which are one run of bits.
+        const index_t begin = this->index->tier_offsets[std::min(min_note_count - 1, this->index->chromatic_note_count)];
+        const index_t end = this->index->tier_offsets[std::min(max_note_count, this->index->chromatic_note_count)];
+        for (index_t word_idx = 0, word_end = this->words.size(); word_idx < word_end; word_idx += 1) {
+            const index_t word_begin = word_idx * scale_index_t::WORD_BIT_COUNT;
+            const index_t word_last = word_begin + scale_index_t::WORD_BIT_COUNT;
+            if (word_last <= begin || word_begin >= end) {
+                this->words[word_idx] = 0;
+            } else {
+                if (word_begin < begin) {
+                    this->words[word_idx] &= ~std::uint64_t(0) << (begin - word_begin);
+                }
+                if (word_last > end) {
+                    this->words[word_idx] &= ~std::uint64_t(0) >> (word_last - end);
+                }
+            }
+        }
+
+        return *this;
+    }
+
+    inline scale_query_t&
+        scale_query_t::With_Interval(const count_t interval)
+        & noexcept
+    {
+        assert(interval > 0 && interval < this->index->chromatic_note_count);
+
+        // an interval and its complement are the same class, as a fifth up is a fourth down.
+        const count_t interval_class = std::min(interval, this->index->chromatic_note_count - interval);
+        const std::uint64_t* const bitset = this->index->Interval_Class_Bitset(interval_class);
+        for (index_t word_idx = 0, word_end = this->words.size(); word_idx < word_end; word_idx += 1) {
+            this->words[word_idx] &= bitset[word_idx];
+        }
+
+        return *this;
+    }
+
+    inline scale_query_t&
+        scale_query_t::Without_Interval(const count_t interval)
+        & noexcept
+    {
+        assert(interval > 0 && interval < this->index->chromatic_note_count);
+
+        const count_t interval_class = std::min(interval, this->index->chromatic_note_count - interval);
+        const std::uint64_t* const bitset = this->index->Interval_Class_Bitset(interval_class);
+        for (index_t word_idx = 0, word_end = this->words.size(); word_idx < word_end; word_idx += 1) {
+            this->words[word_idx] &= ~bitset[word_idx];
+        }
+
+        return *this;
+    }
+
+    inline scale_query_t&
+        scale_query_t::With_Max_Step(const count_t step_size)
+        & noexcept
+    {
+        assert(step_size > 0);
+
+        if (step_size < this->index->chromatic_note_count) {
+            const std::uint64_t* const bitset = this->index->Step_Maximum_Bitset(step_size);
+            for (index_t word_idx = 0, word_end = this->words.size(); word_idx < word_end; word_idx += 1) {
+                this->words[word_idx] &= bitset[word_idx];
+            }
+        }
+
+        return *this;
+    }
+
+    inline scale_query_t&
+        scale_query_t::With_Pitch_Set(const mask_t pitch_set_mask)
+        & noexcept
+    {
+        const count_t chromatic_note_count = this->index->chromatic_note_count;
+        assert(pitch_set_mask != 0);
+        assert((pitch_set_mask & ~Chromatic_Mask(chromatic_note_count)) == 0);
+
+        // every interval of the pitch set has to be somewhere in the scale, which the bitsets narrow down at once.
+        for (count_t interval_class = 1, interval_class_end = scale_analytics_t::Interval_Class_Count(chromatic_note_count);
+             interval_class <= interval_class_end;
+             interval_class += 1) {
+            if (pitch_set_mask & Revolve_Mask(pitch_set_mask, interval_class, chromatic_note_count)) {
+                With_Interval(interval_class);
+            }
+        }
+
+        // the scales that are left are each transposed to every note until one holds the whole pitch set.
+        for (index_t word_idx = 0, word_end = this->words.size(); word_idx < word_end; word_idx += 1) {
+            for (std::uint64_t word = this->words[word_idx]; word != 0; word &= word - 1) {
+                const index_t bit = static_cast<index_t>(std::countr_zero(word));
+                const mask_t scale = this->index->scales[word_idx * scale_index_t::WORD_BIT_COUNT + bit];
+                bool is_included = false;
+                for (index_t distance = 0; distance < chromatic_note_count && !is_included; distance += 1) {
+                    is_included = (Revolve_Mask(scale, distance, chromatic_note_count) & pitch_set_mask) == pitch_set_mask;
+                }
+                if (!is_included) {
+                    this->words[word_idx] &= ~(std::uint64_t(1) << bit);
+                }
+            }
+        }
+
+        return *this;
+    }
+
+    // a temporary query is moved out of, so that it outlives the statement it was made in.
+    inline scale_query_t
+        scale_query_t::With_Note_Count(const count_t note_count)
+        && noexcept
+    {
+        return std::move(With_Note_Count(note_count));
+    }
+
+    inline scale_query_t
+        scale_query_t::With_Note_Counts(const count_t min_note_count, const count_t max_note_count)
+        && noexcept
+    {
+        return std::move(With_Note_Counts(min_note_count, max_note_count));
+    }
+
+    inline scale_query_t
+        scale_query_t::With_Interval(const count_t interval)
+        && noexcept
+    {
+        return std::move(With_Interval(interval));
+    }
+
+    inline scale_query_t
+        scale_query_t::Without_Interval(const count_t interval)
+        && noexcept
+    {
+        return std::move(Without_Interval(interval));
+    }
+
+    inline scale_query_t
+        scale_query_t::With_Max_Step(const count_t step_size)
+        && noexcept
+    {
+        return std::move(With_Max_Step(step_size));
+    }
+
+    inline scale_query_t
+        scale_query_t::With_Pitch_Set(const mask_t pitch_set_mask)
+        && noexcept
+    {
+        return std::move(With_Pitch_Set(pitch_set_mask));
+    }
+
+    inline count_t
+        scale_query_t::Count()
+        const noexcept
+    {
+        count_t count = 0;
+        for (index_t word_idx = 0, word_end = this->words.size(); word_idx < word_end; word_idx += 1) {
+            count += static_cast<count_t>(std::popcount(this->words[word_idx]));
+        }
+
+        return count;
+    }
+
+    inline bool
+        scale_query_t::Has(const index_t scale_idx)
+        const noexcept
+    {
+        assert(scale_idx < this->index->Scale_Count());
+
+        return (this->words[scale_idx / scale_index_t::WORD_BIT_COUNT] >> (scale_idx % scale_index_t::WORD_BIT_COUNT)) & 1;
+    }
+
+    inline scale_query_t::iterator_t
+        scale_query_t::begin()
+        const noexcept
+    {
+        return iterator_t(*this);
+    }
+
+    inline std::default_sentinel_t
+        scale_query_t::end()
+        const noexcept
+    {
+        return std::default_sentinel;
+    }
+
+}
+
+namespace musical_calculator {
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    chromatic_t<CHROMATIC_NOTE_COUNT_p>::chromatic_t(const chromatic_config_t& config) :
+        storage(config.storage),
+        scale_kernel(config.scale_kernel),
+        has_mode_tiers(config.has_mode_tiers),
+        notes(nullptr),
+        masks(nullptr),
+        scale_entries(nullptr),
+        has_scale_memberships(config.has_scale_memberships)
+    {
+        // We allocate enough memory to store all modes in the chromatic scale in one place,
+        // primary for performance purposes and to avoid using more memory than necessary when dissecting the modes.
+        // Masks take one word per mode instead of one word per note, and so need far less of it.
+        // Without mode tiers we need no memory for modes at all.
+        if (this->has_mode_tiers) {
+            if (this->storage == storage_e::NOTES) {
+                this->notes = static_cast<note_t*>(malloc(sizeof(note_t) * CHROMATIC_MODE_NOTE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1]));
+            } else {
+                this->masks = static_cast<mask_t*>(malloc(sizeof(mask_t) * CHROMATIC_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1]));
+            }
+        }
+
+        // the scales of every tier go in one arena, whose size we know exactly up front, and each tier gets its own range.
+        index_t scale_tier_offsets[CHROMATIC_NOTE_COUNT_p + 1] = { 0 };
+        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
+            scale_tier_offsets[idx + 1] = scale_tier_offsets[idx] + Count_Tier_Scales(CHROMATIC_NOTE_COUNT_p, idx + 1).Count();
+        }
+        this->scale_entries = static_cast<std::uint32_t*>(malloc(sizeof(std::uint32_t) * scale_tier_offsets[CHROMATIC_NOTE_COUNT_p]));
+
+        // the destructor doesn't run for a constructor that throws, and so we free what we have ourselves.
+        if (!this->scale_entries || (this->has_mode_tiers && !this->notes && !this->masks)) {
+            free(this->notes);
+            free(this->masks);
+            free(this->scale_entries);
+            throw std::bad_alloc();
+        }
+        try {
+            Build(config, scale_tier_offsets);
+        } catch (...) {
+            free(this->notes);
+            free(this->masks);
+            free(this->scale_entries);
+            throw;
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Build(const chromatic_config_t& config, const index_t* const scale_tier_offsets)
+    {
+        // We concurrently computate modes and subsequently their scales.
+        // Each mode tier and thus scale tier does not rely on any other tier, but the tiers are
+        // badly unbalanced: the ones in the middle have hundreds of thousands of times more modes
+        // than the ones at the ends. So we split each tier into chunks of consecutive modes, and
+        // each chunk becomes a task that generates its modes and then finds the scales among them.
+        // The tasks are spread over every core, and cores that finish early steal from the rest.
+        struct task_t
+        {
+            index_t         tier_idx;
+            note_t*         notes;
+            mask_t*         masks;
+            mode_chunk_t    chunk;
+        };
+
+        std::vector<task_t> tasks;
+        note_t* notes = this->notes;
+        mask_t* masks = this->masks;
+        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
+            if (this->has_scale_memberships) {
+                this->scale_memberships[idx] = scale_membership_t(CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][idx]);
+            }
+
+            if (!this->has_mode_tiers) {
+                // without mode tiers, each scale tier is generated whole, which is cheap enough not to need splitting.
+                tasks.push_back(task_t{ idx, nullptr, nullptr, mode_chunk_t() });
+            } else {
+                this->mode_tiers[idx].notes = notes;
+                this->mode_tiers[idx].masks = masks;
+
+                const std::vector<mode_chunk_t> chunks =
+                    mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Mode_Chunks(idx + 1, MAX_CHUNK_MODE_COUNT);
+                for (index_t chunk_idx = 0, chunk_end = chunks.size(); chunk_idx < chunk_end; chunk_idx += 1) {
+                    tasks.push_back(task_t{ idx, notes, masks, chunks[chunk_idx] });
+                }
+
+                if (this->storage == storage_e::NOTES) {
+                    notes += CHROMATIC_TIER_MODE_NOTE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][idx];
+                } else {
+                    masks += CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][idx];
+                }
+            }
+        }
+
+        // small chromatics are done serially on this thread, which a pool of one worker always does.
+        thread_pool_t serial_thread_pool(1);
+        thread_pool_t& thread_pool =
+            thread_pool_t::Choose(Mode_Count(), config.thread_pool, serial_thread_pool, config.min_parallel_mode_count);
+
+        // but how many of the arena's scales each chunk finds isn't known until it's done. so each task finds its scales in a
+        // buffer on its own stack, with room for one scale per mode of a chunk, and adds just the ones it found to its worker's
+        // results. they are copied into the arena in order of the tasks afterwards, so that each tier's scales come out in the
+        // same order they would if found all at once. without mode tiers, each tier is one task, and its scales go straight
+        // into the arena.
+        task_results_t<std::uint32_t> task_entries(
+            thread_pool.Worker_Count(),
+            this->has_mode_tiers ? tasks.size() : 0,
+            scale_tier_offsets[CHROMATIC_NOTE_COUNT_p]);
+
+        std::vector<count_t> task_scale_counts(tasks.size(), 0);
+        thread_pool.Run_Tasks(
+            tasks.size(),
+            [this, &tasks, &task_scale_counts, scale_tier_offsets, &task_entries](const index_t task_idx, const index_t worker_idx) -> void
+            {
+                const task_t& task = tasks[task_idx];
+                const count_t mode_note_count = task.tier_idx + 1;
+
+                // we always have to calcuate each chunk's modes before each chunk's scales.
+                scale_membership_t* const membership =
+                    this->has_scale_memberships ? &this->scale_memberships[task.tier_idx] : nullptr;
+                if (!this->has_mode_tiers) {
+                    std::uint32_t* const results = this->scale_entries + scale_tier_offsets[task.tier_idx];
+                    scale_generator_t generator(CHROMATIC_NOTE_COUNT_p, mode_note_count);
+                    for (mask_t mask; generator.Next(mask);) {
+                        results[task_scale_counts[task_idx]] = mask;
+                        task_scale_counts[task_idx] += 1;
+                        if (membership) {
+                            membership->Record_Scale(mask, Rank_Mask(mask, CHROMATIC_NOTE_COUNT_p), CHROMATIC_NOTE_COUNT_p);
+                        }
+                    }
+                    return;
+                }
+
+                std::uint32_t chunk_entries[MAX_CHUNK_MODE_COUNT];
+                assert(task.chunk.mode_count <= MAX_CHUNK_MODE_COUNT);
+                if (this->scale_kernel == scale_kernel_e::REVOLVING_DOOR) {
+                    task_scale_counts[task_idx] = scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Find_Revolving_Scales(
+                        task.notes,
+                        task.masks,
+                        task.chunk,
+                        mode_note_count,
+                        chunk_entries,
+                        membership);
+                } else {
+                    if (this->storage == storage_e::NOTES) {
+                        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Generate_Chunk(task.notes, task.chunk, mode_note_count);
+                    } else {
+                        mode_tier_t<CHROMATIC_NOTE_COUNT_p>::Generate_Chunk(task.masks, task.chunk, mode_note_count);
+                    }
+
+                    task_scale_counts[task_idx] = scale_tier_t<CHROMATIC_NOTE_COUNT_p>::Find_Scales(
+                        this->mode_tiers[task.tier_idx],
+                        task.chunk.first_mode_idx,
+                        task.chunk.mode_count,
+                        mode_note_count,
+                        this->scale_kernel,
+                        chunk_entries,
+                        membership);
+                }
+                task_entries.Add(task_idx, worker_idx, chunk_entries, task_scale_counts[task_idx]);
+            }
+        );
+
+        index_t scale_tier_ends[CHROMATIC_NOTE_COUNT_p];
+        std::copy(scale_tier_offsets, scale_tier_offsets + CHROMATIC_NOTE_COUNT_p, scale_tier_ends);
+        for (index_t task_idx = 0, task_end = tasks.size(); task_idx < task_end; task_idx += 1) {
+            const task_t& task = tasks[task_idx];
+            if (this->has_mode_tiers) {
+                std::copy(task_entries.Results(task_idx),
+                          task_entries.Results(task_idx) + task_entries.Result_Count(task_idx),
+                          this->scale_entries + scale_tier_ends[task.tier_idx]);
+            }
+            scale_tier_ends[task.tier_idx] += task_scale_counts[task_idx];
+        }
+
+        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
+            assert(scale_tier_ends[idx] == scale_tier_offsets[idx + 1]);
+            this->scale_tiers[idx] = scale_tier_t<CHROMATIC_NOTE_COUNT_p>(
+                this->scale_entries + scale_tier_offsets[idx],
+                scale_tier_offsets[idx + 1] - scale_tier_offsets[idx],
+                this->mode_tiers[idx].notes);
+            if (this->has_scale_memberships) {
+                this->scale_memberships[idx].Resolve(this->scale_tiers[idx].Scale_Count());
+            }
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    chromatic_t<CHROMATIC_NOTE_COUNT_p>::chromatic_t(const snapshot_t& snapshot) noexcept :
+        storage(storage_e::MASKS),
+        scale_kernel(scale_kernel_e::ROTATIONS),
+        has_mode_tiers(snapshot.Has_Mode_Tiers()),
+        notes(nullptr),
+        masks(nullptr),
+        scale_entries(nullptr),
+        has_scale_memberships(false)
+    {
+        assert(snapshot.Is_Open());
+        assert(snapshot.Chromatic_Note_Count() == CHROMATIC_NOTE_COUNT_p);
+
+        // the tiers view the snapshot where it's mapped, and so we own no memory for them,
+        // and the snapshot has to stay open for as long as we do.
+        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
+            if (this->has_mode_tiers) {
+                count_t mode_count = 0;
+                this->mode_tiers[idx].masks = snapshot.Mode_Tier(idx, &mode_count);
+                assert(mode_count == CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][idx]);
+            }
+
+            count_t scale_count = 0;
+            const mask_t* scale_masks = snapshot.Scale_Tier(idx, &scale_count);
+            this->scale_tiers[idx] = scale_tier_t<CHROMATIC_NOTE_COUNT_p>(scale_masks, scale_count);
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    chromatic_t<CHROMATIC_NOTE_COUNT_p>::~chromatic_t()
+        noexcept
+    {
+        free(this->notes);
+        free(this->masks);
+        free(this->scale_entries);
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    constexpr count_t
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Chromatic_Note_Count()
+        noexcept
+    {
+        return CHROMATIC_NOTE_COUNT_p;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    constexpr count_t
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Mode_Count()
+        noexcept
+    {
+        return CHROMATIC_MODE_COUNTS[Chromatic_Note_Count() - 1];
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    count_t
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Scale_Count()
+        noexcept
+    {
+        count_t count = 0;
+        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
+            count += this->scale_tiers[idx].Scale_Count();
+        }
+
+        return count;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    std::vector<mode_t>
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Modes()
+    {
+        // a chromatic without mode tiers has only its scales.
+        assert(this->has_mode_tiers);
+
+        std::vector<mode_t> modes;
+        modes.reserve(Mode_Count());
+
+        for (index_t tier_idx = 0, tier_end = CHROMATIC_NOTE_COUNT_p;
+             tier_idx < tier_end;
+             tier_idx += 1) {
+            const count_t tier_mode_count = CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][tier_idx];
+            const count_t mode_note_count = tier_idx + 1;
+            for (index_t mode_idx = 0, mode_end = tier_mode_count;
+                 mode_idx < mode_end;
+                 mode_idx += 1) {
+                modes.push_back(this->mode_tiers[tier_idx].Mode(mode_idx, mode_note_count));
+            }
+        }
+
+        return modes;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    std::vector<scale_t>
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Scales()
+    {
+        std::vector<scale_t> scales;
+        scales.reserve(Scale_Count());
+
+        for (index_t tier_idx = 0, tier_end = CHROMATIC_NOTE_COUNT_p;
+             tier_idx < tier_end;
+             tier_idx += 1) {
+            scale_tier_t<CHROMATIC_NOTE_COUNT_p>& scale_tier = this->scale_tiers[tier_idx];
+            const count_t scale_note_count = tier_idx + 1;
+            for (index_t scale_idx = 0, scale_end = scale_tier.Scale_Count();
+                 scale_idx < scale_end;
+                 scale_idx += 1) {
+                scales.push_back(scale_tier.Scale(scale_idx, scale_note_count));
+            }
+        }
+
+        return scales;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    std::vector<mask_t>
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Scale_Masks()
+    {
+        std::vector<mask_t> scales;
+        scales.reserve(Scale_Count());
+        for (index_t tier_idx = 0, tier_end = CHROMATIC_NOTE_COUNT_p; tier_idx < tier_end; tier_idx += 1) {
+            const std::vector<mask_t> tier_scales = this->scale_tiers[tier_idx].Scale_Masks(tier_idx + 1);
+            scales.insert(scales.end(), tier_scales.begin(), tier_scales.end());
+        }
+
+        return scales;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    mode_stream_t
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Mode_Stream()
+        noexcept
+    {
+        return mode_stream_t(CHROMATIC_NOTE_COUNT_p);
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_stream_t
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Scale_Stream()
+        noexcept
+    {
+        return scale_stream_t(CHROMATIC_NOTE_COUNT_p);
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    index_t
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Mode_Index(const mask_t mask)
+        noexcept
+    {
+        return musical_calculator::Mode_Index(mask, CHROMATIC_NOTE_COUNT_p);
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    mode_t
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Mode(const index_t mode_idx)
+        noexcept
+    {
+        assert(mode_idx < Mode_Count());
+
+        // with the mode tiers at hand we can view the mode where it's stored, otherwise we unrank it.
+        const mask_t mask = Mode_Index_Mask(mode_idx, CHROMATIC_NOTE_COUNT_p);
+        if (this->has_mode_tiers) {
+            const count_t mode_note_count = Mask_Note_Count(mask);
+            return this->mode_tiers[mode_note_count - 1].Mode(
+                mode_idx - Tier_First_Mode_Index(mode_note_count, CHROMATIC_NOTE_COUNT_p),
+                mode_note_count);
+        } else {
+            return mode_t(mask);
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Print_Modes()
+        noexcept
+    {
+        assert(this->has_mode_tiers);
+
+        writer_t(std::cout).Write_Modes(*this);
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Print_Scales()
+        noexcept
+    {
+        writer_t(std::cout).Write_Scales(*this);
+    }
+
+}
+
+namespace musical_calculator {
+
+    template <count_t FIXED_NOTE_COUNT_p>
+    count_t
+        chromatic_engine_t::Generate_Chunk(const count_t        chromatic_note_count,
+                                           const count_t        mode_note_count,
+                                           const index_t        first_mode_idx,
+                                           const count_t        mode_count,
+                                           mask_t* const        modes,
+                                           mask_t* const        scales,
+                                           scale_membership_t*  membership,
+                                           const chromatic_engine_t* previous)
+    {
+        // a fixed note count of 0 means the note count is only known at runtime.
+        const count_t note_count = FIXED_NOTE_COUNT_p > 0 ? FIXED_NOTE_COUNT_p : chromatic_note_count;
+        assert(note_count == chromatic_note_count);
+
+        // when there's a previous chromatic, this tier is its tier of the same note count, which are the modes without
+        // the new note, merged with its tier below, which are the modes with the new note once it's added. how many of
+        // each come before this chunk is the rank of the chunk's first mode among those without or with the new note.
+        const mask_t* old_modes = nullptr;
+        const mask_t* old_modes_end = nullptr;
+        const mask_t* new_modes = nullptr;
+        const mask_t* new_modes_end = nullptr;
+        const mask_t new_note_mask = mask_t(1) << (note_count - 1);
+        if (previous) {
+            assert(previous->chromatic_note_count + 1 == note_count);
+            assert(previous->has_mode_tiers);
+
+            const std::vector<index_t>& offsets = previous->mode_tier_offsets;
+            if (mode_note_count < note_count) {
+                old_modes = previous->modes.data() + offsets[mode_note_count - 1];
+                old_modes_end = previous->modes.data() + offsets[mode_note_count];
+            }
+            if (mode_note_count > 1) {
+                new_modes = previous->modes.data() + offsets[mode_note_count - 2];
+                new_modes_end = previous->modes.data() + offsets[mode_note_count - 1];
+            }
+
+            const mask_t first_mask = Unrank_Mask(first_mode_idx, mode_note_count, note_count);
+            const index_t new_mode_idx = (first_mask & new_note_mask) ?
+                Rank_Mask(first_mask & ~new_note_mask, note_count - 1) :
+                first_mode_idx - Rank_Mask(first_mask, note_count - 1);
+            old_modes += first_mode_idx - new_mode_idx;
+            new_modes += new_mode_idx;
+        }
+
+        // the modes are generated a block at a time, and each block is classified at once before the next is generated.
+        // the scales found are written to scales, which has room for every mode of the chunk, and their count returned.
+        count_t scale_count = 0;
+        mask_t block_masks[CLASSIFY_BLOCK_MODE_COUNT];
+        std::uint8_t block_is_scales[CLASSIFY_BLOCK_MODE_COUNT];
+        mask_t mask = previous ? 0 : Unrank_Mask(first_mode_idx, mode_note_count, note_count);
+        for (index_t block_idx = 0, block_end = mode_count; block_idx < block_end; block_idx += CLASSIFY_BLOCK_MODE_COUNT) {
+            const count_t block_mode_count = std::min(CLASSIFY_BLOCK_MODE_COUNT, block_end - block_idx);
+            mask_t* const block = modes ? modes + block_idx : block_masks;
+            if (previous) {
+                // a mode with the new note ends with a step of 1, and its rotation that starts with that step
+                // comes before it unless every step is 1. so only the modes without it need classifying.
+                mask_t old_block_masks[CLASSIFY_BLOCK_MODE_COUNT];
+                std::uint8_t old_block_is_scales[CLASSIFY_BLOCK_MODE_COUNT];
+                std::uint16_t old_block_idxs[CLASSIFY_BLOCK_MODE_COUNT];
+                count_t old_block_mode_count = 0;
+                for (index_t idx = 0; idx < block_mode_count; idx += 1) {
+                    if (new_modes == new_modes_end ||
+                        (old_modes != old_modes_end && Mask_Precedes(*old_modes, *new_modes | new_note_mask))) {
+                        block[idx] = *old_modes;
+                        old_block_masks[old_block_mode_count] = *old_modes;
+                        old_block_idxs[old_block_mode_count] = static_cast<std::uint16_t>(idx);
+                        old_block_mode_count += 1;
+                        old_modes += 1;
+                    } else {
+                        block[idx] = *new_modes | new_note_mask;
+                        block_is_scales[idx] = mode_note_count == note_count;
+                        new_modes += 1;
+                    }
+                }
+
+                Classify_Scale_Masks(old_block_masks, old_block_mode_count, note_count, old_block_is_scales);
+                for (index_t idx = 0; idx < old_block_mode_count; idx += 1) {
+                    block_is_scales[old_block_idxs[idx]] = old_block_is_scales[idx];
+                }
+            } else {
+                for (index_t idx = 0; idx < block_mode_count; idx += 1) {
+                    block[idx] = mask;
+                    mask = Next_Mask(mask, note_count);
+                }
+
+                Classify_Scale_Masks(block, block_mode_count, note_count, block_is_scales);
+            }
+            for (index_t idx = 0; idx < block_mode_count; idx += 1) {
+                if (block_is_scales[idx]) {
+                    scales[scale_count] = block[idx];
+                    scale_count += 1;
+                    if (membership) {
+                        membership->Record_Scale(block[idx], first_mode_idx + block_idx + idx, note_count);
+                    }
+                }
+            }
+        }
+
+        return scale_count;
+    }
+
+    inline count_t
+        chromatic_engine_t::Generate_Chunk(const count_t        chromatic_note_count,
+                                           const count_t        mode_note_count,
+                                           const index_t        first_mode_idx,
+                                           const count_t        mode_count,
+                                           mask_t* const        modes,
+                                           mask_t* const        scales,
+                                           scale_membership_t*  membership,
+                                           const chromatic_engine_t* previous)
+    {
+        static_assert(std::size(SPECIALIZED_NOTE_COUNTS) == 2);
+
+        if (chromatic_note_count == SPECIALIZED_NOTE_COUNTS[0]) {
+            return Generate_Chunk<SPECIALIZED_NOTE_COUNTS[0]>(chromatic_note_count, mode_note_count, first_mode_idx, mode_count, modes, scales, membership, previous);
+        } else if (chromatic_note_count == SPECIALIZED_NOTE_COUNTS[1]) {
+            return Generate_Chunk<SPECIALIZED_NOTE_COUNTS[1]>(chromatic_note_count, mode_note_count, first_mode_idx, mode_count, modes, scales, membership, previous);
+        } else {
+            return Generate_Chunk<0>(chromatic_note_count, mode_note_count, first_mode_idx, mode_count, modes, scales, membership, previous);
+        }
+    }
+
+    inline chromatic_engine_t::chromatic_engine_t(const count_t                 chromatic_note_count,
+                                                  const chromatic_config_t&     config,
+                                                  const chromatic_engine_t*     previous) :
+        chromatic_note_count(chromatic_note_count),
+        has_mode_tiers(config.has_mode_tiers),
+        modes(),
+        mode_tier_offsets(chromatic_note_count + 1, 0),
+        scales(),
+        scale_tier_offsets(chromatic_note_count + 1, 0),
+        has_scale_memberships(config.has_scale_memberships),
+        scale_memberships()
+    {
+        assert(chromatic_note_count > 0);
+        assert(chromatic_note_count <= MAX_CHROMATIC_NOTE_COUNT);
+        assert(!previous || previous->chromatic_note_count + 1 == chromatic_note_count);
+
+        for (index_t idx = 0, end = chromatic_note_count; idx < end; idx += 1) {
+            this->mode_tier_offsets[idx + 1] = this->mode_tier_offsets[idx] + Tier_Mode_Count(idx + 1);
+            this->scale_tier_offsets[idx + 1] = this->scale_tier_offsets[idx] + Count_Tier_Scales(chromatic_note_count, idx + 1).Count();
+        }
+        this->scales.resize(this->scale_tier_offsets[chromatic_note_count]);
+        if (previous && (!previous->has_mode_tiers || !this->has_mode_tiers)) {
+            previous = nullptr;
+        }
+        if (this->has_mode_tiers) {
+            this->modes.resize(Mode_Count());
+        }
+        if (this->has_scale_memberships) {
+            this->scale_memberships.reserve(chromatic_note_count);
+            for (index_t idx = 0, end = chromatic_note_count; idx < end; idx += 1) {
+                this->scale_memberships.push_back(scale_membership_t(Tier_Mode_Count(idx + 1)));
+            }
+        }
+
+        // like chromatic_t, each tier is split into chunks that are each a task, and each task finds its scales
+        // on the side to be joined in order afterwards. without mode tiers, each tier is one task for its generator,
+        // which writes the tier's scales straight into its range.
+        struct task_t
+        {
+            index_t tier_idx;
+            index_t first_mode_idx;
+            count_t mode_count;
+        };
+
+        std::vector<task_t> tasks;
+        for (index_t tier_idx = 0, tier_end = chromatic_note_count; tier_idx < tier_end; tier_idx += 1) {
+            const count_t tier_mode_count = Tier_Mode_Count(tier_idx + 1);
+            if (!this->has_mode_tiers) {
+                tasks.push_back(task_t{ tier_idx, 0, tier_mode_count });
+            } else {
+                for (index_t mode_idx = 0; mode_idx < tier_mode_count; mode_idx += MAX_CHUNK_MODE_COUNT) {
+                    tasks.push_back(task_t{ tier_idx, mode_idx, std::min(MAX_CHUNK_MODE_COUNT, tier_mode_count - mode_idx) });
+                }
+            }
+        }
+
+        thread_pool_t serial_thread_pool(1);
+        thread_pool_t& thread_pool =
+            thread_pool_t::Choose(Mode_Count(), config.thread_pool, serial_thread_pool, config.min_parallel_mode_count);
+
+        task_results_t<mask_t> task_scales(
+            thread_pool.Worker_Count(),
+            this->has_mode_tiers ? tasks.size() : 0,
+            this->scales.size());
+        thread_pool.Run_Tasks(
+            tasks.size(),
+            [this, previous, &tasks, &task_scales](const index_t task_idx, const index_t worker_idx) -> void
+            {
+                const task_t& task = tasks[task_idx];
+                const count_t mode_note_count = task.tier_idx + 1;
+                scale_membership_t* const membership =
+                    this->has_scale_memberships ? &this->scale_memberships[task.tier_idx] : nullptr;
+                if (!this->has_mode_tiers) {
+                    mask_t* const scales = this->scales.data() + this->scale_tier_offsets[task.tier_idx];
+                    count_t scale_count = 0;
+                    scale_generator_t generator(this->chromatic_note_count, mode_note_count);
+                    for (mask_t mask; generator.Next(mask);) {
+                        scales[scale_count] = mask;
+                        scale_count += 1;
+                        if (membership) {
+                            membership->Record_Scale(mask, Rank_Mask(mask, this->chromatic_note_count), this->chromatic_note_count);
+                        }
+                    }
+                    assert(scale_count == Tier_Scale_Count(mode_note_count));
+                } else {
+                    mask_t chunk_scales[MAX_CHUNK_MODE_COUNT];
+                    assert(task.mode_count <= MAX_CHUNK_MODE_COUNT);
+                    const count_t scale_count = Generate_Chunk(
+                        this->chromatic_note_count,
+                        mode_note_count,
+                        task.first_mode_idx,
+                        task.mode_count,
+                        this->modes.data() + this->mode_tier_offsets[task.tier_idx] + task.first_mode_idx,
+                        chunk_scales,
+                        membership,
+                        previous);
+                    task_scales.Add(task_idx, worker_idx, chunk_scales, scale_count);
+                }
+            }
+        );
+
+        if (this->has_mode_tiers) {
+            std::vector<index_t> scale_tier_ends(this->scale_tier_offsets.begin(), this->scale_tier_offsets.end() - 1);
+            for (index_t task_idx = 0, task_end = tasks.size(); task_idx < task_end; task_idx += 1) {
+                index_t& scale_tier_end = scale_tier_ends[tasks[task_idx].tier_idx];
+                std::copy(task_scales.Results(task_idx),
+                          task_scales.Results(task_idx) + task_scales.Result_Count(task_idx),
+                          this->scales.data() + scale_tier_end);
+                scale_tier_end += task_scales.Result_Count(task_idx);
+            }
+            for (index_t idx = 0, end = chromatic_note_count; idx < end; idx += 1) {
+                assert(scale_tier_ends[idx] == this->scale_tier_offsets[idx + 1]);
+            }
+        }
+        if (this->has_scale_memberships) {
+            for (index_t idx = 0, end = chromatic_note_count; idx < end; idx += 1) {
+                this->scale_memberships[idx].Resolve(Tier_Scale_Count(idx + 1));
+            }
+        }
+    }
+
+    inline count_t
+        chromatic_engine_t::Chromatic_Note_Count()
+        noexcept
+    {
+        return this->chromatic_note_count;
+    }
+
+    inline count_t
+        chromatic_engine_t::Mode_Count()
+        noexcept
+    {
+        return CHROMATIC_MODE_COUNTS[this->chromatic_note_count - 1];
+    }
+
+    inline count_t
+        chromatic_engine_t::Scale_Count()
+        noexcept
+    {
+        return this->scales.size();
+    }
+
+    inline count_t
+        chromatic_engine_t::Tier_Mode_Count(const count_t mode_note_count)
+        noexcept
+    {
+        assert(mode_note_count > 0 && mode_note_count <= this->chromatic_note_count);
+
+        return CHROMATIC_TIER_MODE_COUNTS[this->chromatic_note_count - 1][mode_note_count - 1];
+    }
+
+    inline count_t
+        chromatic_engine_t::Tier_Scale_Count(const count_t scale_note_count)
+        noexcept
+    {
+        assert(scale_note_count > 0 && scale_note_count <= this->chromatic_note_count);
+
+        return this->scale_tier_offsets[scale_note_count] - this->scale_tier_offsets[scale_note_count - 1];
+    }
+
+    inline mode_t
+        chromatic_engine_t::Mode(const index_t mode_idx)
+        noexcept
+    {
+        assert(mode_idx < Mode_Count());
+
+        if (this->has_mode_tiers) {
+            return mode_t(this->modes[mode_idx]);
+        } else {
+            return mode_t(Mode_Index_Mask(mode_idx, this->chromatic_note_count));
+        }
+    }
+
+    inline mode_t
+        chromatic_engine_t::Tier_Mode(const index_t mode_idx, const count_t mode_note_count)
+        noexcept
+    {
+        assert(mode_idx < Tier_Mode_Count(mode_note_count));
+
+        return Mode(this->mode_tier_offsets[mode_note_count - 1] + mode_idx);
+    }
+
+    inline scale_t
+        chromatic_engine_t::Tier_Scale(const index_t scale_idx, const count_t scale_note_count)
+        noexcept
+    {
+        assert(scale_idx < Tier_Scale_Count(scale_note_count));
+
+        return scale_t(this->scales[this->scale_tier_offsets[scale_note_count - 1] + scale_idx]);
+    }
+
+    inline std::vector<mode_t>
+        chromatic_engine_t::Modes()
+    {
+        // a chromatic without mode tiers has only its scales.
+        assert(this->has_mode_tiers);
+
+        std::vector<mode_t> modes;
+        modes.reserve(Mode_Count());
+        for (index_t idx = 0, end = Mode_Count(); idx < end; idx += 1) {
+            modes.push_back(mode_t(this->modes[idx]));
+        }
+
+        return modes;
+    }
+
+    inline std::vector<scale_t>
+        chromatic_engine_t::Scales()
+    {
+        std::vector<scale_t> scales;
+        scales.reserve(Scale_Count());
+        for (index_t idx = 0, end = Scale_Count(); idx < end; idx += 1) {
+            scales.push_back(scale_t(this->scales[idx]));
+        }
+
+        return scales;
+    }
+
+    inline std::vector<mask_t>
+        chromatic_engine_t::Scale_Masks()
+    {
+        // the tiers are already laid out one after another, in order.
+        return this->scales;
+    }
+
+    inline void
+        chromatic_engine_t::Print_Modes()
+        noexcept
+    {
+        assert(this->has_mode_tiers);
+
+        writer_t(std::cout).Write_Modes(*this);
+    }
+
+    inline void
+        chromatic_engine_t::Print_Scales()
+        noexcept
+    {
+        writer_t(std::cout).Write_Scales(*this);
+    }
+
+}
+
+namespace musical_calculator {
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    consteval std::array<mask_t, baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::MODE_COUNT>
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Bake_Modes()
+        noexcept
+    {
+        std::array<mask_t, MODE_COUNT> modes = {};
+        index_t mode_idx = 0;
+        for (count_t mode_note_count = 1; mode_note_count <= CHROMATIC_NOTE_COUNT_p; mode_note_count += 1) {
+            for (mask_t mask = Chromatic_Mask(mode_note_count); mask != 0; mask = Next_Mask(mask, CHROMATIC_NOTE_COUNT_p)) {
+                modes[mode_idx] = mask;
+                mode_idx += 1;
+            }
+        }
+
+        return modes;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    consteval std::array<mask_t, baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::SCALE_COUNT>
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Bake_Scales()
+        noexcept
+    {
+        // the modes are already in order, and so the scales come out in order too.
+        const std::array<mask_t, MODE_COUNT> modes = Bake_Modes();
+        std::array<mask_t, SCALE_COUNT> scales = {};
+        index_t scale_idx = 0;
+        for (index_t mode_idx = 0; mode_idx < MODE_COUNT; mode_idx += 1) {
+            if (Is_Scale_Mask(modes[mode_idx], CHROMATIC_NOTE_COUNT_p)) {
+                scales[scale_idx] = modes[mode_idx];
+                scale_idx += 1;
+            }
+        }
+
+        return scales;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    consteval std::array<index_t, CHROMATIC_NOTE_COUNT_p + 1>
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Bake_Scale_Tier_Offsets()
+        noexcept
+    {
+        std::array<index_t, CHROMATIC_NOTE_COUNT_p + 1> offsets = {};
+        for (count_t scale_note_count = 1; scale_note_count <= CHROMATIC_NOTE_COUNT_p; scale_note_count += 1) {
+            offsets[scale_note_count] = offsets[scale_note_count - 1] + Count_Tier_Scales(CHROMATIC_NOTE_COUNT_p, scale_note_count).Count();
+        }
+
+        return offsets;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    constexpr count_t
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Chromatic_Note_Count()
+        noexcept
+    {
+        return CHROMATIC_NOTE_COUNT_p;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    constexpr count_t
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Mode_Count()
+        noexcept
+    {
+        return MODE_COUNT;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    constexpr count_t
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Scale_Count()
+        noexcept
+    {
+        return SCALE_COUNT;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    constexpr count_t
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Tier_Mode_Count(const count_t mode_note_count)
+        noexcept
+    {
+        assert(mode_note_count > 0 && mode_note_count <= CHROMATIC_NOTE_COUNT_p);
+
+        return CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][mode_note_count - 1];
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    constexpr count_t
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Tier_Scale_Count(const count_t scale_note_count)
+        noexcept
+    {
+        assert(scale_note_count > 0 && scale_note_count <= CHROMATIC_NOTE_COUNT_p);
+
+        return SCALE_TIER_OFFSETS[scale_note_count] - SCALE_TIER_OFFSETS[scale_note_count - 1];
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    constexpr const mask_t*
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Mode_Tier(const count_t mode_note_count)
+        noexcept
+    {
+        assert(mode_note_count > 0 && mode_note_count <= CHROMATIC_NOTE_COUNT_p);
+
+        return MODES.data() + Tier_First_Mode_Index(mode_note_count, CHROMATIC_NOTE_COUNT_p);
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    constexpr const mask_t*
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Scale_Tier(const count_t scale_note_count)
+        noexcept
+    {
+        assert(scale_note_count > 0 && scale_note_count <= CHROMATIC_NOTE_COUNT_p);
+
+        return SCALES.data() + SCALE_TIER_OFFSETS[scale_note_count - 1];
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    std::vector<mode_t>
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Modes()
+    {
+        std::vector<mode_t> modes;
+        modes.reserve(MODE_COUNT);
+        for (index_t idx = 0; idx < MODE_COUNT; idx += 1) {
+            modes.push_back(mode_t(MODES[idx]));
+        }
+
+        return modes;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    std::vector<scale_t>
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Scales()
+    {
+        std::vector<scale_t> scales;
+        scales.reserve(SCALE_COUNT);
+        for (index_t idx = 0; idx < SCALE_COUNT; idx += 1) {
+            scales.push_back(scale_t(SCALES[idx]));
+        }
+
+        return scales;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Print_Modes()
+        noexcept
+    {
+        writer_t writer(std::cout);
+        for (index_t idx = 0; idx < MODE_COUNT; idx += 1) {
+            writer.Write_Mode(mode_t(MODES[idx]));
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        baked_chromatic_t<CHROMATIC_NOTE_COUNT_p>::Print_Scales()
+        noexcept
+    {
+        writer_t writer(std::cout);
+        for (index_t idx = 0; idx < SCALE_COUNT; idx += 1) {
+            writer.Write_Mode(scale_t(SCALES[idx]));
+        }
+    }
+
+}
+
+namespace musical_calculator {
+
+    // every scale of the largest chromatic needs its own index in an entry.
+    static_assert(Count_Scales(MAX_CHROMATIC_NOTE_COUNT) < wide_count_t(1ull << scale_lookup_t<MAX_CHROMATIC_NOTE_COUNT>::SCALE_IDX_BIT_COUNT));
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    std::uint32_t
+        scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::Pack_Location(const scale_location_t& location)
+        noexcept
+    {
+        assert(location.scale_idx < (1ull << SCALE_IDX_BIT_COUNT));
+        assert(location.scale_note_count > 0);
+        assert(location.rotation < location.scale_note_count);
+
+        return static_cast<std::uint32_t>(
+            location.scale_idx |
+            ((location.scale_note_count - 1) << SCALE_IDX_BIT_COUNT) |
+            (location.rotation << (SCALE_IDX_BIT_COUNT + NOTE_COUNT_BIT_COUNT)));
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_location_t
+        scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::Unpack_Location(const std::uint32_t entry)
+        noexcept
+    {
+        scale_location_t location;
+        location.scale_idx = entry & ((1u << SCALE_IDX_BIT_COUNT) - 1);
+        location.scale_note_count = ((entry >> SCALE_IDX_BIT_COUNT) & ((1u << NOTE_COUNT_BIT_COUNT) - 1)) + 1;
+        location.rotation = (entry >> (SCALE_IDX_BIT_COUNT + NOTE_COUNT_BIT_COUNT)) & ((1u << ROTATION_BIT_COUNT) - 1);
+
+        return location;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    mask_t
+        scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::Pitch_Set_Mode(const mask_t pitch_set_mask, index_t* const transposition)
+        noexcept
+    {
+        assert(pitch_set_mask != 0);
+        assert((pitch_set_mask & ~Chromatic_Mask(CHROMATIC_NOTE_COUNT_p)) == 0);
+
+        // the lowest pitch becomes 1, and as it's the lowest, nothing needs to wrap around.
+        const index_t distance = static_cast<index_t>(std::countr_zero(pitch_set_mask));
+        if (transposition) {
+            *transposition = distance;
+        }
+
+        return pitch_set_mask >> distance;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::scale_lookup_t(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic) :
+        entries(count_t(1) << (CHROMATIC_NOTE_COUNT_p - 1), 0),
+        mapped_entries(nullptr)
+    {
+        scale_location_t location;
+        location.scale_idx = 0;
         for (index_t tier_idx = 0, tier_end = CHROMATIC_NOTE_COUNT_p;
              tier_idx < tier_end;
              tier_idx += 1) {
-            const scale_tier_t& scale_tier = this->scale_tiers[tier_idx];
-            const count_t scale_note_count = tier_idx + 1;
-            for (index_t scale_idx = 0, scale_end = scale_tier.scales.size();
+            scale_tier_t<CHROMATIC_NOTE_COUNT_p>& scale_tier = chromatic.scale_tiers[tier_idx];
+            location.scale_note_count = tier_idx + 1;
+            for (index_t scale_idx = 0, scale_end = scale_tier.Scale_Count();
                  scale_idx < scale_end;
-                 scale_idx += 1) {
-                scales.push_back(scale_t(scale_tier.scales[scale_idx], scale_note_count));
+                 scale_idx += 1, location.scale_idx += 1) {
+                const mask_t scale_mask = scale_tier.Scale(scale_idx, location.scale_note_count).Mask();
+
+                // we go through the rotations backwards so that when a scale repeats itself, the smallest rotation is kept.
+                note_t scale_notes[MAX_CHROMATIC_NOTE_COUNT];
+                Mask_Notes(scale_mask, scale_notes);
+                for (index_t rotation = location.scale_note_count; rotation > 0;) {
+                    rotation -= 1;
+                    location.rotation = rotation;
+                    const mask_t mode_mask = Revolve_Mask(scale_mask, scale_notes[rotation] - 1, CHROMATIC_NOTE_COUNT_p);
+                    this->entries[mode_mask >> 1] = Pack_Location(location);
+                }
+            }
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::scale_lookup_t(const snapshot_t& snapshot) noexcept :
+        entries(),
+        mapped_entries(nullptr)
+    {
+        assert(snapshot.Is_Open());
+        assert(snapshot.Chromatic_Note_Count() == CHROMATIC_NOTE_COUNT_p);
+        assert(snapshot.Has_Scale_Lookup());
+
+        count_t entry_count = 0;
+        this->mapped_entries = snapshot.Scale_Lookup(&entry_count);
+        assert(entry_count == count_t(1) << (CHROMATIC_NOTE_COUNT_p - 1));
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    count_t
+        scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::Entry_Count()
+        noexcept
+    {
+        if (this->mapped_entries) {
+            return count_t(1) << (CHROMATIC_NOTE_COUNT_p - 1);
+        } else {
+            return this->entries.size();
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    const std::uint32_t*
+        scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::Entries()
+        noexcept
+    {
+        if (this->mapped_entries) {
+            return this->mapped_entries;
+        } else {
+            return this->entries.data();
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_location_t
+        scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::Find(const mask_t mode_mask)
+        noexcept
+    {
+        assert(mode_mask & 1);
+        assert((mode_mask >> 1) < Entry_Count());
+
+        return Unpack_Location(Entries()[mode_mask >> 1]);
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::Find(const mask_t* const mode_masks,
+                                                     const count_t mode_count,
+                                                     scale_location_t* const results)
+        noexcept
+    {
+        // each lookup is independent of the others, so the loads overlap one another in flight.
+        const std::uint32_t* const entries = Entries();
+        for (index_t idx = 0, end = mode_count; idx < end; idx += 1) {
+            assert(mode_masks[idx] & 1);
+            results[idx] = Unpack_Location(entries[mode_masks[idx] >> 1]);
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    scale_location_t
+        scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::Find_Pitch_Set(const mask_t pitch_set_mask, index_t* const transposition)
+        noexcept
+    {
+        return Find(Pitch_Set_Mode(pitch_set_mask, transposition));
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::Find_Pitch_Sets(const mask_t* const pitch_set_masks,
+                                                                const count_t pitch_set_count,
+                                                                scale_location_t* const results)
+        noexcept
+    {
+        const std::uint32_t* const entries = Entries();
+        for (index_t idx = 0, end = pitch_set_count; idx < end; idx += 1) {
+            results[idx] = Unpack_Location(entries[Pitch_Set_Mode(pitch_set_masks[idx]) >> 1]);
+        }
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline std::uint64_t
+        snapshot_t::Checksum(const void* data, const std::uint64_t size, std::uint64_t checksum)
+        noexcept
+    {
+        // this is FNV-1a taken a word at a time instead of a byte at a time, which is eight times as fast,
+        // and still catches any torn or truncated write, which is all it's for.
+        constexpr std::uint64_t PRIME = 0x100000001B3;
+
+        const std::uint8_t* bytes = static_cast<const std::uint8_t*>(data);
+        std::uint64_t idx = 0;
+        for (; idx + sizeof(std::uint64_t) <= size; idx += sizeof(std::uint64_t)) {
+            std::uint64_t word;
+            std::memcpy(&word, bytes + idx, sizeof(word));
+            checksum = (checksum ^ word) * PRIME;
+        }
+        for (; idx < size; idx += 1) {
+            checksum = (checksum ^ bytes[idx]) * PRIME;
+        }
+
+        return checksum;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    bool
+        snapshot_t::Write(const char* path,
+                          chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic,
+                          scale_lookup_t<CHROMATIC_NOTE_COUNT_p>* scale_lookup)
+        noexcept
+    {
+        // we lay out every section before writing anything, so the header can be written first.
+        snapshot_header_t header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.byte_order = BYTE_ORDER_MARK;
+        header.chromatic_note_count = static_cast<std::uint32_t>(CHROMATIC_NOTE_COUNT_p);
+        header.flags =
+            (chromatic.has_mode_tiers ? HAS_MODE_TIERS : 0) |
+            (scale_lookup ? HAS_SCALE_LOOKUP : 0);
+
+        std::uint64_t offset = 0;
+        auto Lay_Out = [&offset](snapshot_section_t& section, const count_t count, const count_t item_size) -> void
+        {
+            offset = (offset + SECTION_ALIGNMENT - 1) / SECTION_ALIGNMENT * SECTION_ALIGNMENT;
+            section.offset = offset;
+            section.count = count;
+            offset += count * item_size;
+        };
+
+        offset = sizeof(snapshot_header_t);
+        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
+            if (chromatic.has_mode_tiers) {
+                Lay_Out(header.mode_tiers[idx], CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][idx], sizeof(mask_t));
+            }
+        }
+        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
+            Lay_Out(header.scale_tiers[idx], chromatic.scale_tiers[idx].Scale_Count(), sizeof(mask_t));
+        }
+        if (scale_lookup) {
+            Lay_Out(header.scale_lookup, scale_lookup->Entry_Count(), sizeof(std::uint32_t));
+        }
+        header.file_size = offset;
+
+        std::FILE* file = std::fopen(path, "wb");
+        if (!file) {
+            return false;
+        }
+
+        bool is_written = true;
+        std::uint64_t written_size = 0;
+        auto Write_Bytes = [file, &is_written, &written_size](const void* data, const std::uint64_t size) -> void
+        {
+            if (is_written && size > 0) {
+                is_written = std::fwrite(data, 1, size, file) == size;
+                written_size += size;
+            }
+        };
+        auto Write_Padding = [&Write_Bytes, &written_size](const std::uint64_t to_offset) -> void
+        {
+            constexpr std::uint8_t ZEROS[SECTION_ALIGNMENT] = {};
+            assert(to_offset >= written_size && to_offset - written_size <= SECTION_ALIGNMENT);
+            Write_Bytes(ZEROS, to_offset - written_size);
+        };
+
+        // the header is written again at the end, once its checksums are known.
+        Write_Bytes(&header, sizeof(header));
+
+        // modes and scales are written through a buffer of masks, whichever way the chromatic stores them.
+        std::vector<mask_t> buffer;
+        buffer.reserve(MAX_CHUNK_MODE_COUNT);
+        auto Write_Masks = [&](const snapshot_section_t& section, auto&& Mask) -> void
+        {
+            Write_Padding(section.offset);
+            for (index_t idx = 0, end = section.count; idx < end; idx += 1) {
+                buffer.push_back(Mask(idx));
+                if (buffer.size() == MAX_CHUNK_MODE_COUNT || idx + 1 == end) {
+                    header.section_checksum = Checksum(buffer.data(), buffer.size() * sizeof(mask_t), header.section_checksum);
+                    Write_Bytes(buffer.data(), buffer.size() * sizeof(mask_t));
+                    buffer.clear();
+                }
+            }
+        };
+
+        header.section_checksum = Checksum(nullptr, 0);
+        for (index_t tier_idx = 0, tier_end = CHROMATIC_NOTE_COUNT_p; tier_idx < tier_end; tier_idx += 1) {
+            if (chromatic.has_mode_tiers) {
+                mode_tier_t<CHROMATIC_NOTE_COUNT_p>& mode_tier = chromatic.mode_tiers[tier_idx];
+                const count_t mode_note_count = tier_idx + 1;
+                Write_Masks(
+                    header.mode_tiers[tier_idx],
+                    [&mode_tier, mode_note_count](const index_t mode_idx) -> mask_t
+                    {
+                        return mode_tier.Mode(mode_idx, mode_note_count).Mask();
+                    }
+                );
+            }
+        }
+        for (index_t tier_idx = 0, tier_end = CHROMATIC_NOTE_COUNT_p; tier_idx < tier_end; tier_idx += 1) {
+            scale_tier_t<CHROMATIC_NOTE_COUNT_p>& scale_tier = chromatic.scale_tiers[tier_idx];
+            const count_t scale_note_count = tier_idx + 1;
+            Write_Masks(
+                header.scale_tiers[tier_idx],
+                [&scale_tier, scale_note_count](const index_t scale_idx) -> mask_t
+                {
+                    return scale_tier.Scale(scale_idx, scale_note_count).Mask();
+                }
+            );
+        }
+        if (scale_lookup) {
+            const std::uint64_t size = header.scale_lookup.count * sizeof(std::uint32_t);
+            Write_Padding(header.scale_lookup.offset);
+            header.section_checksum = Checksum(scale_lookup->Entries(), size, header.section_checksum);
+            Write_Bytes(scale_lookup->Entries(), size);
+        }
+        assert(!is_written || written_size == header.file_size);
+
+        header.header_checksum = Checksum(&header, offsetof(snapshot_header_t, header_checksum));
+        if (std::fseek(file, 0, SEEK_SET) == 0) {
+            written_size = 0;
+            Write_Bytes(&header, sizeof(header));
+        } else {
+            is_written = false;
+        }
+
+        return std::fclose(file) == 0 && is_written;
+    }
+
+    inline snapshot_t::snapshot_t() noexcept :
+        data(nullptr),
+        size(0)
+#if defined(_WIN32)
+        ,
+        file(INVALID_HANDLE_VALUE),
+        mapping(nullptr)
+#endif
+    {
+    }
+
+    inline snapshot_t::snapshot_t(const char* path) noexcept :
+        snapshot_t()
+    {
+        Open(path);
+    }
+
+    inline snapshot_t::~snapshot_t() noexcept
+    {
+        Close();
+    }
+
+    inline bool
+        snapshot_t::Open(const char* path)
+        noexcept
+    {
+        Close();
+        if (!Map(path)) {
+            return false;
+        }
+
+        // we check everything in the header that we'll rely on later, so that a bad file is refused here
+        // and not found out about by reading past the end of the mapping.
+        const snapshot_header_t& header = Header();
+        bool is_valid =
+            this->size >= sizeof(snapshot_header_t) &&
+            std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+            header.version == VERSION &&
+            header.byte_order == BYTE_ORDER_MARK &&
+            header.file_size == this->size &&
+            header.header_checksum == Checksum(&header, offsetof(snapshot_header_t, header_checksum)) &&
+            header.chromatic_note_count > 0 &&
+            header.chromatic_note_count <= MAX_CHROMATIC_NOTE_COUNT;
+
+        auto Is_Valid_Section = [this](const snapshot_section_t& section, const count_t item_size) -> bool
+        {
+            return
+                section.offset % SECTION_ALIGNMENT == 0 &&
+                section.offset <= this->size &&
+                section.count <= (this->size - section.offset) / item_size;
+        };
+        for (index_t idx = 0, end = MAX_CHROMATIC_NOTE_COUNT; is_valid && idx < end; idx += 1) {
+            is_valid =
+                Is_Valid_Section(header.mode_tiers[idx], sizeof(mask_t)) &&
+                Is_Valid_Section(header.scale_tiers[idx], sizeof(mask_t));
+        }
+        is_valid = is_valid && Is_Valid_Section(header.scale_lookup, sizeof(std::uint32_t));
+
+        // the chromatic and the scale lookup read their sections without checking how long they are,
+        // and so each has to hold exactly as many items as the chromatic has, and be there only when flagged.
+        is_valid = is_valid && (header.flags & ~(HAS_MODE_TIERS | HAS_SCALE_LOOKUP)) == 0;
+        for (index_t idx = 0, end = MAX_CHROMATIC_NOTE_COUNT; is_valid && idx < end; idx += 1) {
+            const count_t chromatic_note_count = header.chromatic_note_count;
+            const bool is_tier = idx < chromatic_note_count;
+            const std::uint64_t mode_count = is_tier && (header.flags & HAS_MODE_TIERS) ?
+                CHROMATIC_TIER_MODE_COUNTS[chromatic_note_count - 1][idx] :
+                0;
+            const std::uint64_t scale_count = is_tier ?
+                Count_Tier_Scales(chromatic_note_count, idx + 1).Count() :
+                0;
+            is_valid =
+                header.mode_tiers[idx].count == mode_count &&
+                header.scale_tiers[idx].count == scale_count;
+        }
+        is_valid = is_valid && header.scale_lookup.count == ((header.flags & HAS_SCALE_LOOKUP) ?
+            std::uint64_t(1) << (header.chromatic_note_count - 1) :
+            0);
+
+        if (!is_valid) {
+            Close();
+        }
+
+        return is_valid;
+    }
+
+    inline bool
+        snapshot_t::Map(const char* path)
+        noexcept
+    {
+#if defined(_WIN32)
+        this->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (this->file == INVALID_HANDLE_VALUE) {
+            return false;
+        }
+
+        LARGE_INTEGER file_size;
+        if (!GetFileSizeEx(this->file, &file_size) || file_size.QuadPart < LONGLONG(sizeof(snapshot_header_t))) {
+            Close();
+            return false;
+        }
+
+        this->mapping = CreateFileMappingA(this->file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!this->mapping) {
+            Close();
+            return false;
+        }
+
+        this->data = static_cast<const std::uint8_t*>(MapViewOfFile(this->mapping, FILE_MAP_READ, 0, 0, 0));
+        if (!this->data) {
+            Close();
+            return false;
+        }
+        this->size = static_cast<std::uint64_t>(file_size.QuadPart);
+
+        return true;
+#else
+        const int file = ::open(path, O_RDONLY);
+        if (file < 0) {
+            return false;
+        }
+
+        // the mapping keeps the file open on its own, so we can close our descriptor either way.
+        struct stat file_stat;
+        void* data = MAP_FAILED;
+        if (::fstat(file, &file_stat) == 0 && file_stat.st_size >= off_t(sizeof(snapshot_header_t))) {
+            data = ::mmap(nullptr, static_cast<std::size_t>(file_stat.st_size), PROT_READ, MAP_SHARED, file, 0);
+        }
+        ::close(file);
+        if (data == MAP_FAILED) {
+            return false;
+        }
+
+        this->data = static_cast<const std::uint8_t*>(data);
+        this->size = static_cast<std::uint64_t>(file_stat.st_size);
+
+        return true;
+#endif
+    }
+
+    inline void
+        snapshot_t::Close()
+        noexcept
+    {
+#if defined(_WIN32)
+        if (this->data) {
+            UnmapViewOfFile(this->data);
+        }
+        if (this->mapping) {
+            CloseHandle(this->mapping);
+        }
+        if (this->file != INVALID_HANDLE_VALUE) {
+            CloseHandle(this->file);
+        }
+        this->file = INVALID_HANDLE_VALUE;
+        this->mapping = nullptr;
+#else
+        if (this->data) {
+            ::munmap(const_cast<std::uint8_t*>(this->data), static_cast<std::size_t>(this->size));
+        }
+#endif
+        this->data = nullptr;
+        this->size = 0;
+    }
+
+    inline bool
+        snapshot_t::Verify()
+        const noexcept
+    {
+        assert(Is_Open());
+
+        const snapshot_header_t& header = Header();
+        std::uint64_t checksum = Checksum(nullptr, 0);
+        for (index_t idx = 0, end = header.chromatic_note_count; idx < end; idx += 1) {
+            const snapshot_section_t& section = header.mode_tiers[idx];
+            checksum = Checksum(this->data + section.offset, section.count * sizeof(mask_t), checksum);
+        }
+        for (index_t idx = 0, end = header.chromatic_note_count; idx < end; idx += 1) {
+            const snapshot_section_t& section = header.scale_tiers[idx];
+            checksum = Checksum(this->data + section.offset, section.count * sizeof(mask_t), checksum);
+        }
+        checksum = Checksum(this->data + header.scale_lookup.offset, header.scale_lookup.count * sizeof(std::uint32_t), checksum);
+
+        return checksum == header.section_checksum;
+    }
+
+    inline bool
+        snapshot_t::Is_Open()
+        const noexcept
+    {
+        return this->data != nullptr;
+    }
+
+    inline const snapshot_header_t&
+        snapshot_t::Header()
+        const noexcept
+    {
+        assert(this->data);
+
+        return *reinterpret_cast<const snapshot_header_t*>(this->data);
+    }
+
+    inline count_t
+        snapshot_t::Chromatic_Note_Count()
+        const noexcept
+    {
+        return Header().chromatic_note_count;
+    }
+
+    inline bool
+        snapshot_t::Has_Mode_Tiers()
+        const noexcept
+    {
+        return (Header().flags & HAS_MODE_TIERS) != 0;
+    }
+
+    inline bool
+        snapshot_t::Has_Scale_Lookup()
+        const noexcept
+    {
+        return (Header().flags & HAS_SCALE_LOOKUP) != 0;
+    }
+
+    inline const void*
+        snapshot_t::Section(const snapshot_section_t& section, const count_t item_size)
+        const noexcept
+    {
+        static_cast<void>(item_size);
+        assert(section.offset + section.count * item_size <= this->size);
+
+        return this->data + section.offset;
+    }
+
+    inline const mask_t*
+        snapshot_t::Mode_Tier(const index_t tier_idx, count_t* const mode_count)
+        const noexcept
+    {
+        assert(Has_Mode_Tiers());
+        assert(tier_idx < Chromatic_Note_Count());
+
+        const snapshot_section_t& section = Header().mode_tiers[tier_idx];
+        if (mode_count) {
+            *mode_count = section.count;
+        }
+
+        return static_cast<const mask_t*>(Section(section, sizeof(mask_t)));
+    }
+
+    inline const mask_t*
+        snapshot_t::Scale_Tier(const index_t tier_idx, count_t* const scale_count)
+        const noexcept
+    {
+        assert(tier_idx < Chromatic_Note_Count());
+
+        const snapshot_section_t& section = Header().scale_tiers[tier_idx];
+        if (scale_count) {
+            *scale_count = section.count;
+        }
+
+        return static_cast<const mask_t*>(Section(section, sizeof(mask_t)));
+    }
+
+    inline const std::uint32_t*
+        snapshot_t::Scale_Lookup(count_t* const entry_count)
+        const noexcept
+    {
+        assert(Has_Scale_Lookup());
+
+        const snapshot_section_t& section = Header().scale_lookup;
+        if (entry_count) {
+            *entry_count = section.count;
+        }
+
+        return static_cast<const std::uint32_t*>(Section(section, sizeof(std::uint32_t)));
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline index_t
+        shard_t::Shard_First_Mode_Index(const count_t chromatic_note_count, const index_t shard_idx, const count_t shard_count)
+        noexcept
+    {
+        assert(chromatic_note_count > 0);
+        assert(chromatic_note_count <= MAX_CHROMATIC_NOTE_COUNT);
+        assert(shard_count > 0);
+        assert(shard_idx <= shard_count);
+
+        // no mode count is large enough for this to overflow, and the shards differ in size by one mode at most.
+        return CHROMATIC_MODE_COUNTS[chromatic_note_count - 1] * shard_idx / shard_count;
+    }
+
+    inline shard_t::shard_t() noexcept :
+        chromatic_note_count(0),
+        first_mode_idx(0),
+        mode_count(0),
+        scale_tiers()
+    {
+    }
+
+    inline shard_t::shard_t(const count_t           chromatic_note_count,
+                            const index_t           first_mode_idx,
+                            const count_t           mode_count,
+                            thread_pool_t* const    thread_pool) :
+        chromatic_note_count(chromatic_note_count),
+        first_mode_idx(first_mode_idx),
+        mode_count(mode_count),
+        scale_tiers(chromatic_note_count)
+    {
+        assert(chromatic_note_count > 0);
+        assert(chromatic_note_count <= MAX_CHROMATIC_NOTE_COUNT);
+        assert(first_mode_idx + mode_count <= CHROMATIC_MODE_COUNTS[chromatic_note_count - 1]);
+
+        // each tier that the range covers is split into chunks, each of which is a task, just like an engine's tiers.
+        struct task_t
+        {
+            index_t tier_idx;
+            index_t first_mode_idx;
+            count_t mode_count;
+        };
+
+        std::vector<task_t> tasks;
+        const index_t end_mode_idx = first_mode_idx + mode_count;
+        for (index_t tier_idx = 0, tier_first_mode_idx = 0; tier_idx < chromatic_note_count; tier_idx += 1) {
+            const index_t tier_end_mode_idx = tier_first_mode_idx + CHROMATIC_TIER_MODE_COUNTS[chromatic_note_count - 1][tier_idx];
+            const index_t first_idx = std::max(first_mode_idx, tier_first_mode_idx);
+            const index_t end_idx = std::min(end_mode_idx, tier_end_mode_idx);
+            for (index_t mode_idx = first_idx; mode_idx < end_idx; mode_idx += MAX_CHUNK_MODE_COUNT) {
+                tasks.push_back(task_t{ tier_idx, mode_idx - tier_first_mode_idx, std::min(MAX_CHUNK_MODE_COUNT, end_idx - mode_idx) });
+            }
+            tier_first_mode_idx = tier_end_mode_idx;
+        }
+
+        thread_pool_t serial_thread_pool(1);
+        thread_pool_t& chosen_thread_pool = thread_pool_t::Choose(mode_count, thread_pool, serial_thread_pool);
+
+        task_results_t<mask_t> task_scales(chosen_thread_pool.Worker_Count(), tasks.size());
+        chosen_thread_pool.Run_Tasks(
+            tasks.size(),
+            [this, &tasks, &task_scales](const index_t task_idx, const index_t worker_idx) -> void
+            {
+                const task_t& task = tasks[task_idx];
+                mask_t chunk_scales[MAX_CHUNK_MODE_COUNT];
+                assert(task.mode_count <= MAX_CHUNK_MODE_COUNT);
+                const count_t scale_count = chromatic_engine_t::Generate_Chunk(
+                    this->chromatic_note_count,
+                    task.tier_idx + 1,
+                    task.first_mode_idx,
+                    task.mode_count,
+                    nullptr,
+                    chunk_scales);
+                task_scales.Add(task_idx, worker_idx, chunk_scales, scale_count);
+            }
+        );
+
+        // how many scales each tier has is only known now, and so each is sized exactly before it's filled.
+        std::vector<index_t> scale_tier_ends(this->scale_tiers.size(), 0);
+        for (index_t task_idx = 0, task_end = tasks.size(); task_idx < task_end; task_idx += 1) {
+            scale_tier_ends[tasks[task_idx].tier_idx] += task_scales.Result_Count(task_idx);
+        }
+        for (index_t tier_idx = 0, tier_end = this->scale_tiers.size(); tier_idx < tier_end; tier_idx += 1) {
+            this->scale_tiers[tier_idx].resize(scale_tier_ends[tier_idx]);
+            scale_tier_ends[tier_idx] = 0;
+        }
+        for (index_t task_idx = 0, task_end = tasks.size(); task_idx < task_end; task_idx += 1) {
+            const index_t tier_idx = tasks[task_idx].tier_idx;
+            std::copy(task_scales.Results(task_idx),
+                      task_scales.Results(task_idx) + task_scales.Result_Count(task_idx),
+                      this->scale_tiers[tier_idx].data() + scale_tier_ends[tier_idx]);
+            scale_tier_ends[tier_idx] += task_scales.Result_Count(task_idx);
+        }
+    }
+
+    inline bool
+        shard_t::Read(const char* path)
+    {
+        std::FILE* file = std::fopen(path, "rb");
+        if (!file) {
+            return false;
+        }
+
+        // everything in the header is checked before any of it is trusted, and the scales are checked once read.
+        shard_header_t header;
+        bool is_valid =
+            std::fread(&header, sizeof(header), 1, file) == 1 &&
+            std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) == 0 &&
+            header.version == VERSION &&
+            header.byte_order == snapshot_t::BYTE_ORDER_MARK &&
+            header.header_checksum == snapshot_t::Checksum(&header, offsetof(shard_header_t, header_checksum)) &&
+            header.chromatic_note_count > 0 &&
+            header.chromatic_note_count <= MAX_CHROMATIC_NOTE_COUNT &&
+            header.mode_count <= CHROMATIC_MODE_COUNTS[header.chromatic_note_count - 1] &&
+            header.first_mode_idx <= CHROMATIC_MODE_COUNTS[header.chromatic_note_count - 1] - header.mode_count;
+        for (index_t idx = 0, end = MAX_CHROMATIC_NOTE_COUNT; is_valid && idx < end; idx += 1) {
+            is_valid = header.scale_counts[idx] <= header.mode_count;
+        }
+
+        std::uint64_t scale_checksum = snapshot_t::Checksum(nullptr, 0);
+        std::vector<std::vector<mask_t>> scale_tiers;
+        if (is_valid) {
+            scale_tiers.resize(header.chromatic_note_count);
+            for (index_t idx = 0, end = header.chromatic_note_count; is_valid && idx < end; idx += 1) {
+                scale_tiers[idx].resize(header.scale_counts[idx]);
+                is_valid = scale_tiers[idx].empty() ||
+                    std::fread(scale_tiers[idx].data(), sizeof(mask_t), scale_tiers[idx].size(), file) == scale_tiers[idx].size();
+                scale_checksum = snapshot_t::Checksum(scale_tiers[idx].data(), scale_tiers[idx].size() * sizeof(mask_t), scale_checksum);
+            }
+            is_valid = is_valid && scale_checksum == header.scale_checksum;
+        }
+        std::fclose(file);
+
+        if (is_valid) {
+            this->chromatic_note_count = header.chromatic_note_count;
+            this->first_mode_idx = header.first_mode_idx;
+            this->mode_count = header.mode_count;
+            this->scale_tiers = std::move(scale_tiers);
+        }
+
+        return is_valid;
+    }
+
+    inline bool
+        shard_t::Write(const char* path)
+        const noexcept
+    {
+        shard_header_t header;
+        std::memset(&header, 0, sizeof(header));
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.byte_order = snapshot_t::BYTE_ORDER_MARK;
+        header.chromatic_note_count = this->chromatic_note_count;
+        header.first_mode_idx = this->first_mode_idx;
+        header.mode_count = this->mode_count;
+        header.scale_checksum = snapshot_t::Checksum(nullptr, 0);
+        for (index_t idx = 0, end = this->chromatic_note_count; idx < end; idx += 1) {
+            header.scale_counts[idx] = this->scale_tiers[idx].size();
+            header.scale_checksum = snapshot_t::Checksum(
+                this->scale_tiers[idx].data(), this->scale_tiers[idx].size() * sizeof(mask_t), header.scale_checksum);
+        }
+        header.header_checksum = snapshot_t::Checksum(&header, offsetof(shard_header_t, header_checksum));
+
+        std::FILE* file = std::fopen(path, "wb");
+        if (!file) {
+            return false;
+        }
+
+        // the tiers outside the shard's range are empty, and have no data to write.
+        bool is_written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+        for (index_t idx = 0, end = this->chromatic_note_count; is_written && idx < end; idx += 1) {
+            if (!this->scale_tiers[idx].empty()) {
+                is_written = std::fwrite(this->scale_tiers[idx].data(), sizeof(mask_t), this->scale_tiers[idx].size(), file) ==
+                    this->scale_tiers[idx].size();
+            }
+        }
+
+        return std::fclose(file) == 0 && is_written;
+    }
+
+    inline bool
+        shard_t::Merge(const shard_t& other)
+    {
+        // an empty shard takes on whichever shard is merged into it first.
+        if (this->chromatic_note_count == 0) {
+            *this = other;
+            return true;
+        }
+
+        if (other.chromatic_note_count != this->chromatic_note_count) {
+            return false;
+        }
+
+        // the scales of each tier are in order of their modes, and so the shard that comes first keeps its scales first.
+        if (other.first_mode_idx == this->first_mode_idx + this->mode_count) {
+            for (index_t idx = 0, end = this->chromatic_note_count; idx < end; idx += 1) {
+                this->scale_tiers[idx].insert(this->scale_tiers[idx].end(), other.scale_tiers[idx].begin(), other.scale_tiers[idx].end());
+            }
+        } else if (other.first_mode_idx + other.mode_count == this->first_mode_idx) {
+            for (index_t idx = 0, end = this->chromatic_note_count; idx < end; idx += 1) {
+                this->scale_tiers[idx].insert(this->scale_tiers[idx].begin(), other.scale_tiers[idx].begin(), other.scale_tiers[idx].end());
+            }
+            this->first_mode_idx = other.first_mode_idx;
+        } else {
+            return false;
+        }
+        this->mode_count += other.mode_count;
+
+        return true;
+    }
+
+    inline bool
+        shard_t::Is_Complete()
+        const noexcept
+    {
+        return
+            this->chromatic_note_count > 0 &&
+            this->first_mode_idx == 0 &&
+            this->mode_count == CHROMATIC_MODE_COUNTS[this->chromatic_note_count - 1];
+    }
+
+    inline count_t
+        shard_t::Chromatic_Note_Count()
+        const noexcept
+    {
+        return this->chromatic_note_count;
+    }
+
+    inline index_t
+        shard_t::First_Mode_Index()
+        const noexcept
+    {
+        return this->first_mode_idx;
+    }
+
+    inline count_t
+        shard_t::Mode_Count()
+        const noexcept
+    {
+        return this->mode_count;
+    }
+
+    inline count_t
+        shard_t::Scale_Count()
+        const noexcept
+    {
+        count_t scale_count = 0;
+        for (index_t idx = 0, end = this->chromatic_note_count; idx < end; idx += 1) {
+            scale_count += this->scale_tiers[idx].size();
+        }
+
+        return scale_count;
+    }
+
+    inline count_t
+        shard_t::Tier_Scale_Count(const count_t scale_note_count)
+        const noexcept
+    {
+        assert(scale_note_count > 0 && scale_note_count <= this->chromatic_note_count);
+
+        return this->scale_tiers[scale_note_count - 1].size();
+    }
+
+    inline scale_t
+        shard_t::Tier_Scale(const index_t scale_idx, const count_t scale_note_count)
+        const noexcept
+    {
+        assert(scale_idx < Tier_Scale_Count(scale_note_count));
+
+        return scale_t(this->scale_tiers[scale_note_count - 1][scale_idx]);
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline char*
+        writer_t::Format_Notes(char* cursor, const note_t* const notes, const count_t note_count, const format_e format)
+        noexcept
+    {
+        assert(format != format_e::MASKS);
+        assert(note_count <= MAX_MASK_NOTE_COUNT);
+
+        const char delimiter =
+            format == format_e::CSV ? ',' :
+            format == format_e::TSV ? '\t' :
+            ' ';
+        for (index_t idx = 0, end = note_count; idx < end; idx += 1) {
+            // notes never have more than two digits.
+            const note_t note = notes[idx];
+            if (idx > 0) {
+                *cursor++ = delimiter;
+            }
+            if (note >= 10) {
+                *cursor++ = static_cast<char>('0' + note / 10);
+            }
+            *cursor++ = static_cast<char>('0' + note % 10);
+        }
+        *cursor++ = '\n';
+
+        return cursor;
+    }
+
+    inline char*
+        writer_t::Format_Mask(char* cursor, const mask_t mask, const format_e format)
+        noexcept
+    {
+        if (format == format_e::MASKS) {
+            std::memcpy(cursor, &mask, sizeof(mask));
+            return cursor + sizeof(mask);
+        } else {
+            note_t notes[MAX_MASK_NOTE_COUNT];
+            Mask_Notes(mask, notes);
+            return Format_Notes(cursor, notes, Mask_Note_Count(mask), format);
+        }
+    }
+
+    inline char*
+        writer_t::Format_Mode(char* cursor, const mode_t& mode, const format_e format)
+        noexcept
+    {
+        if (mode.notes && format != format_e::MASKS) {
+            return Format_Notes(cursor, mode.notes, mode.note_count, format);
+        } else if (mode.notes) {
+            return Format_Mask(cursor, Notes_Mask(mode.notes, mode.note_count), format);
+        } else {
+            return Format_Mask(cursor, mode.mask, format);
+        }
+    }
+
+    inline writer_t::writer_t(std::FILE* file, const format_e format) :
+        format(format),
+        file(file),
+        stream(nullptr),
+        buffer(BUFFER_SIZE),
+        buffer_size(0),
+        is_good(file != nullptr)
+    {
+    }
+
+    inline writer_t::writer_t(std::ostream& stream, const format_e format) :
+        format(format),
+        file(nullptr),
+        stream(&stream),
+        buffer(BUFFER_SIZE),
+        buffer_size(0),
+        is_good(true)
+    {
+    }
+
+    inline writer_t::~writer_t()
+        noexcept
+    {
+        Flush();
+    }
+
+    inline bool
+        writer_t::Is_Good()
+        noexcept
+    {
+        return this->is_good;
+    }
+
+    inline bool
+        writer_t::Flush()
+        noexcept
+    {
+        // once a write has failed we stop writing, and the failure is kept so it can be checked at the end.
+        if (this->is_good && this->buffer_size > 0) {
+            if (this->file) {
+                this->is_good = std::fwrite(this->buffer.data(), 1, this->buffer_size, this->file) == this->buffer_size &&
+                    std::fflush(this->file) == 0;
+            } else {
+                this->is_good = static_cast<bool>(this->stream->write(this->buffer.data(), this->buffer_size).flush());
+            }
+        }
+        this->buffer_size = 0;
+
+        return this->is_good;
+    }
+
+    inline void
+        writer_t::Write_Bytes(const char* const bytes, const count_t byte_count)
+        noexcept
+    {
+        if (this->buffer_size + byte_count > this->buffer.size()) {
+            Flush();
+        }
+        if (byte_count > this->buffer.size()) {
+            // a run larger than the whole buffer gains nothing from being copied into it.
+            if (this->is_good) {
+                if (this->file) {
+                    this->is_good = std::fwrite(bytes, 1, byte_count, this->file) == byte_count;
+                } else {
+                    this->is_good = static_cast<bool>(this->stream->write(bytes, byte_count));
+                }
+            }
+        } else {
+            std::memcpy(this->buffer.data() + this->buffer_size, bytes, byte_count);
+            this->buffer_size += byte_count;
+        }
+    }
+
+    inline void
+        writer_t::Write_Mode(const mode_t& mode)
+        noexcept
+    {
+        if (this->buffer_size + MAX_FORMATTED_MODE_SIZE > this->buffer.size()) {
+            Flush();
+        }
+        char* const begin = this->buffer.data() + this->buffer_size;
+        this->buffer_size += Format_Mode(begin, mode, this->format) - begin;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        writer_t::Write_Modes(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic, thread_pool_t* thread_pool)
+    {
+        assert(chromatic.has_mode_tiers);
+
+        std::vector<write_chunk_t> chunks;
+        for (index_t tier_idx = 0, tier_end = CHROMATIC_NOTE_COUNT_p; tier_idx < tier_end; tier_idx += 1) {
+            const count_t mode_count = CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][tier_idx];
+            for (index_t idx = 0; idx < mode_count; idx += MAX_CHUNK_MODE_COUNT) {
+                chunks.push_back(write_chunk_t{ tier_idx, idx, std::min(MAX_CHUNK_MODE_COUNT, mode_count - idx) });
+            }
+        }
+
+        // like the chromatic itself, small ones are written serially.
+        thread_pool_t serial_thread_pool(1);
+        Write_Chunks(
+            chunks,
+            thread_pool_t::Choose(chromatic.Mode_Count(), thread_pool, serial_thread_pool),
+            [&chromatic](const index_t tier_idx, const index_t mode_idx) -> mode_t
+            {
+                return chromatic.mode_tiers[tier_idx].Mode(mode_idx, tier_idx + 1);
+            }
+        );
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        writer_t::Write_Scales(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic, thread_pool_t* thread_pool)
+    {
+        std::vector<write_chunk_t> chunks;
+        for (index_t tier_idx = 0, tier_end = CHROMATIC_NOTE_COUNT_p; tier_idx < tier_end; tier_idx += 1) {
+            const count_t scale_count = chromatic.scale_tiers[tier_idx].Scale_Count();
+            for (index_t idx = 0; idx < scale_count; idx += MAX_CHUNK_SCALE_COUNT) {
+                chunks.push_back(write_chunk_t{ tier_idx, idx, std::min(MAX_CHUNK_SCALE_COUNT, scale_count - idx) });
+            }
+        }
+
+        thread_pool_t serial_thread_pool(1);
+        Write_Chunks(
+            chunks,
+            thread_pool_t::Choose(chromatic.Scale_Count(), thread_pool, serial_thread_pool),
+            [&chromatic](const index_t tier_idx, const index_t scale_idx) -> mode_t
+            {
+                return chromatic.scale_tiers[tier_idx].Scale(scale_idx, tier_idx + 1);
+            }
+        );
+    }
+
+    inline void
+        writer_t::Write_Modes(chromatic_engine_t& engine, thread_pool_t* thread_pool)
+    {
+        assert(engine.has_mode_tiers);
+
+        std::vector<write_chunk_t> chunks;
+        for (index_t tier_idx = 0, tier_end = engine.Chromatic_Note_Count(); tier_idx < tier_end; tier_idx += 1) {
+            const count_t mode_count = engine.Tier_Mode_Count(tier_idx + 1);
+            for (index_t idx = 0; idx < mode_count; idx += MAX_CHUNK_MODE_COUNT) {
+                chunks.push_back(write_chunk_t{ tier_idx, idx, std::min(MAX_CHUNK_MODE_COUNT, mode_count - idx) });
+            }
+        }
+
+        thread_pool_t serial_thread_pool(1);
+        Write_Chunks(
+            chunks,
+            thread_pool_t::Choose(engine.Mode_Count(), thread_pool, serial_thread_pool),
+            [&engine](const index_t tier_idx, const index_t mode_idx) -> mode_t
+            {
+                return engine.Tier_Mode(mode_idx, tier_idx + 1);
+            }
+        );
+    }
+
+    inline void
+        writer_t::Write_Scales(chromatic_engine_t& engine, thread_pool_t* thread_pool)
+    {
+        std::vector<write_chunk_t> chunks;
+        for (index_t tier_idx = 0, tier_end = engine.Chromatic_Note_Count(); tier_idx < tier_end; tier_idx += 1) {
+            const count_t scale_count = engine.Tier_Scale_Count(tier_idx + 1);
+            for (index_t idx = 0; idx < scale_count; idx += MAX_CHUNK_SCALE_COUNT) {
+                chunks.push_back(write_chunk_t{ tier_idx, idx, std::min(MAX_CHUNK_SCALE_COUNT, scale_count - idx) });
+            }
+        }
+
+        thread_pool_t serial_thread_pool(1);
+        Write_Chunks(
+            chunks,
+            thread_pool_t::Choose(engine.Scale_Count(), thread_pool, serial_thread_pool),
+            [&engine](const index_t tier_idx, const index_t scale_idx) -> mode_t
+            {
+                return engine.Tier_Scale(scale_idx, tier_idx + 1);
+            }
+        );
+    }
+
+    template <typename mode_at_t>
+    void
+        writer_t::Write_Chunks(const std::vector<write_chunk_t>& chunks, thread_pool_t& thread_pool, mode_at_t&& Mode_At)
+    {
+        // a chunk is formatted straight into our own buffer when it's done serially,
+        // which saves the copy, and otherwise into a buffer of its own.
+        if (thread_pool.Worker_Count() <= 1) {
+            for (index_t chunk_idx = 0, chunk_end = chunks.size(); chunk_idx < chunk_end; chunk_idx += 1) {
+                const write_chunk_t& chunk = chunks[chunk_idx];
+                for (index_t idx = chunk.first_idx, end = chunk.first_idx + chunk.count; idx < end; idx += 1) {
+                    Write_Mode(Mode_At(chunk.tier_idx, idx));
+                }
             }
+            return;
         }
 
-        return scales;
+        const count_t window_chunk_count = thread_pool.Worker_Count() * WINDOW_CHUNKS_PER_WORKER;
+        std::vector<std::vector<char>> chunk_buffers(std::min(window_chunk_count, chunks.size()));
+        std::vector<count_t> chunk_buffer_sizes(chunk_buffers.size());
+        for (index_t window_idx = 0, window_end = chunks.size(); window_idx < window_end; window_idx += window_chunk_count) {
+            const count_t chunk_count = std::min(window_chunk_count, window_end - window_idx);
+            thread_pool.Run_Tasks(
+                chunk_count,
+                [this, &chunks, &chunk_buffers, &chunk_buffer_sizes, &Mode_At, window_idx](const index_t task_idx) -> void
+                {
+                    const write_chunk_t& chunk = chunks[window_idx + task_idx];
+                    std::vector<char>& chunk_buffer = chunk_buffers[task_idx];
+                    if (chunk_buffer.size() < chunk.count * MAX_FORMATTED_MODE_SIZE) {
+                        chunk_buffer.resize(chunk.count * MAX_FORMATTED_MODE_SIZE);
+                    }
+
+                    char* const begin = chunk_buffer.data();
+                    char* cursor = begin;
+                    for (index_t idx = chunk.first_idx, end = chunk.first_idx + chunk.count; idx < end; idx += 1) {
+                        cursor = Format_Mode(cursor, Mode_At(chunk.tier_idx, idx), this->format);
+                    }
+                    chunk_buffer_sizes[task_idx] = cursor - begin;
+                }
+            );
+            for (index_t task_idx = 0; task_idx < chunk_count; task_idx += 1) {
+                Write_Bytes(chunk_buffers[task_idx].data(), chunk_buffer_sizes[task_idx]);
+            }
+        }
     }
 
+}
+
+namespace musical_calculator {
+
     template <count_t CHROMATIC_NOTE_COUNT_p>
-    void
-        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Print_Modes()
+    mask_t
+        pitch_set_server_t<CHROMATIC_NOTE_COUNT_p>::Parse_Pitch_Set(const char* cursor, const char* const end)
         noexcept
     {
-        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
-            this->mode_tiers[idx].Print_Modes(CHROMATIC_TIER_MODE_COUNTS[CHROMATIC_NOTE_COUNT_p - 1][idx], idx + 1);
+        // anything that isn't a note of the chromatic or a separator makes the whole line invalid, which is a mask of 0.
+        mask_t pitch_set = 0;
+        while (cursor < end) {
+            if (*cursor >= '0' && *cursor <= '9') {
+                note_t note = 0;
+                for (; cursor < end && *cursor >= '0' && *cursor <= '9'; cursor += 1) {
+                    note = note * 10 + (*cursor - '0');
+                    if (note > CHROMATIC_NOTE_COUNT_p) {
+                        return 0;
+                    }
+                }
+                if (note == 0) {
+                    return 0;
+                }
+                pitch_set |= mask_t(1) << (note - 1);
+            } else if (*cursor == ' ' || *cursor == ',' || *cursor == '\t' || *cursor == '\r') {
+                cursor += 1;
+            } else {
+                return 0;
+            }
+        }
+
+        return pitch_set;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    char*
+        pitch_set_server_t<CHROMATIC_NOTE_COUNT_p>::Format_Answer(char* cursor, const pitch_set_answer_t& answer, const format_e format)
+        noexcept
+    {
+        if (format == format_e::MASKS) {
+            std::memcpy(cursor, &answer, sizeof(answer));
+            return cursor + sizeof(answer);
+        } else if (!answer.is_valid) {
+            constexpr char INVALID[] = "invalid\n";
+            std::memcpy(cursor, INVALID, sizeof(INVALID) - 1);
+            return cursor + sizeof(INVALID) - 1;
+        }
+
+        // the scale's notes end in a newline, which becomes the tab before the numbers that follow them.
+        cursor = writer_t::Format_Mask(cursor, answer.scale_mask, format_e::TEXT);
+        cursor[-1] = '\t';
+        auto Format_Number = [&cursor](const count_t number, const char delimiter) -> void
+        {
+            cursor = std::to_chars(cursor, cursor + 20, number).ptr;
+            *cursor++ = delimiter;
+        };
+        Format_Number(answer.scale_note_count, '\t');
+        Format_Number(answer.rotation, '\t');
+        Format_Number(answer.mode_idx, '\t');
+        Format_Number(answer.transposition, '\n');
+
+        return cursor;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    pitch_set_server_t<CHROMATIC_NOTE_COUNT_p>::pitch_set_server_t(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic,
+                                                                   scale_lookup_t<CHROMATIC_NOTE_COUNT_p>& scale_lookup,
+                                                                   const format_e format) :
+        scale_lookup(scale_lookup),
+        format(format),
+        scale_masks()
+    {
+        // the lookup gives each scale by its index in the whole chromatic, and so their masks are laid out the same way.
+        this->scale_masks.reserve(chromatic.Scale_Count());
+        for (index_t tier_idx = 0, tier_end = CHROMATIC_NOTE_COUNT_p; tier_idx < tier_end; tier_idx += 1) {
+            scale_tier_t<CHROMATIC_NOTE_COUNT_p>& scale_tier = chromatic.scale_tiers[tier_idx];
+            for (index_t scale_idx = 0, scale_end = scale_tier.Scale_Count(); scale_idx < scale_end; scale_idx += 1) {
+                this->scale_masks.push_back(scale_tier.Scale(scale_idx, tier_idx + 1).Mask());
+            }
         }
     }
 
     template <count_t CHROMATIC_NOTE_COUNT_p>
     void
-        chromatic_t<CHROMATIC_NOTE_COUNT_p>::Print_Scales()
+        pitch_set_server_t<CHROMATIC_NOTE_COUNT_p>::Answer(const mask_t* const     pitch_sets,
+                                                           const count_t           pitch_set_count,
+                                                           pitch_set_answer_t* const answers)
         noexcept
     {
-        for (index_t idx = 0, end = CHROMATIC_NOTE_COUNT_p; idx < end; idx += 1) {
-            this->scale_tiers[idx].Print_Scales(idx + 1);
+        const mask_t chromatic_mask = Chromatic_Mask(CHROMATIC_NOTE_COUNT_p);
+        for (index_t idx = 0, end = pitch_set_count; idx < end; idx += 1) {
+            const mask_t pitch_set = pitch_sets[idx];
+            pitch_set_answer_t& answer = answers[idx];
+            if (pitch_set == 0 || (pitch_set & ~chromatic_mask) != 0) {
+                std::memset(&answer, 0, sizeof(answer));
+                continue;
+            }
+
+            index_t transposition = 0;
+            const mask_t mode = scale_lookup_t<CHROMATIC_NOTE_COUNT_p>::Pitch_Set_Mode(pitch_set, &transposition);
+            const scale_location_t location = this->scale_lookup.Find(mode);
+
+            // a lookup mapped from a snapshot that wasn't verified could still name a scale that isn't there.
+            if (location.scale_idx >= this->scale_masks.size()) {
+                std::memset(&answer, 0, sizeof(answer));
+            } else {
+                answer.scale_mask = this->scale_masks[location.scale_idx];
+                answer.scale_idx = static_cast<std::uint32_t>(location.scale_idx);
+                answer.mode_idx = static_cast<std::uint32_t>(Mode_Index(mode, CHROMATIC_NOTE_COUNT_p));
+                answer.scale_note_count = static_cast<std::uint8_t>(location.scale_note_count);
+                answer.rotation = static_cast<std::uint8_t>(location.rotation);
+                answer.transposition = static_cast<std::uint8_t>(transposition);
+                answer.is_valid = 1;
+            }
+        }
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    bool
+        pitch_set_server_t<CHROMATIC_NOTE_COUNT_p>::Serve(const int input_fd, const int output_fd)
+    {
+        auto Read = [](const int fd, char* const bytes, const count_t byte_count) -> std::int64_t
+        {
+            while (true) {
+#if defined(_WIN32)
+                const std::int64_t read_count = _read(fd, bytes, static_cast<unsigned int>(byte_count));
+#else
+                const std::int64_t read_count = read(fd, bytes, byte_count);
+#endif
+                if (read_count >= 0 || errno != EINTR) {
+                    return read_count;
+                }
+            }
+        };
+#if defined(_WIN32)
+        const bool is_socket = false;
+#else
+        // a socket is written with send, so that a client that goes away mid-answer fails the write
+        // instead of raising SIGPIPE, which would end the whole process and every other client with it.
+        struct stat output_status;
+        const bool is_socket = fstat(output_fd, &output_status) == 0 && S_ISSOCK(output_status.st_mode);
+#endif
+        auto Write = [is_socket](const int fd, const char* bytes, count_t byte_count) -> bool
+        {
+            while (byte_count > 0) {
+#if defined(_WIN32)
+                static_cast<void>(is_socket);
+                const std::int64_t written_count = _write(fd, bytes, static_cast<unsigned int>(byte_count));
+#elif defined(MSG_NOSIGNAL)
+                const std::int64_t written_count = is_socket ? send(fd, bytes, byte_count, MSG_NOSIGNAL) : write(fd, bytes, byte_count);
+#else
+                const std::int64_t written_count = is_socket ? send(fd, bytes, byte_count, 0) : write(fd, bytes, byte_count);
+#endif
+                if (written_count < 0 && errno != EINTR) {
+                    return false;
+                } else if (written_count > 0) {
+                    bytes += written_count;
+                    byte_count -= written_count;
+                }
+            }
+            return true;
+        };
+
+        std::vector<char> input(READ_BUFFER_SIZE);
+        std::vector<mask_t> pitch_sets(BATCH_QUERY_COUNT);
+        std::vector<pitch_set_answer_t> answers(BATCH_QUERY_COUNT);
+        std::vector<char> output(BATCH_QUERY_COUNT * MAX_FORMATTED_ANSWER_SIZE);
+        count_t input_size = 0;
+        count_t pitch_set_count = 0;
+        bool is_skipping_line = false;
+        bool is_good = true;
+
+        auto Answer_Batch = [&]() -> void
+        {
+            if (pitch_set_count > 0) {
+                Answer(pitch_sets.data(), pitch_set_count, answers.data());
+                char* cursor = output.data();
+                for (index_t idx = 0, end = pitch_set_count; idx < end; idx += 1) {
+                    cursor = Format_Answer(cursor, answers[idx], this->format);
+                }
+                is_good = is_good && Write(output_fd, output.data(), cursor - output.data());
+                pitch_set_count = 0;
+            }
+        };
+        auto Add_Query = [&](const mask_t pitch_set) -> void
+        {
+            pitch_sets[pitch_set_count] = pitch_set;
+            pitch_set_count += 1;
+            if (pitch_set_count == BATCH_QUERY_COUNT) {
+                Answer_Batch();
+            }
+        };
+
+        while (is_good) {
+            const std::int64_t read_count = Read(input_fd, input.data() + input_size, input.size() - input_size);
+            if (read_count < 0) {
+                is_good = false;
+                break;
+            }
+            const bool is_end = read_count == 0;
+            input_size += read_count;
+
+            // every whole query in the buffer is parsed, and whatever is left of a partial one is kept for the next read.
+            index_t parsed_size = 0;
+            if (this->format == format_e::MASKS) {
+                for (; parsed_size + sizeof(mask_t) <= input_size; parsed_size += sizeof(mask_t)) {
+                    mask_t pitch_set;
+                    std::memcpy(&pitch_set, input.data() + parsed_size, sizeof(pitch_set));
+                    Add_Query(pitch_set);
+                }
+            } else {
+                while (parsed_size < input_size) {
+                    const char* const begin = input.data() + parsed_size;
+                    const char* const end = input.data() + input_size;
+                    const char* const line_end = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+                    if (line_end) {
+                        if (is_skipping_line) {
+                            is_skipping_line = false;
+                        } else {
+                            Add_Query(Parse_Pitch_Set(begin, line_end));
+                        }
+                        parsed_size = line_end - input.data() + 1;
+                    } else {
+                        // the last line may not end in a newline, and a line that fills the whole buffer never will.
+                        // such a line is answered as invalid, and the rest of it is skipped when it comes in.
+                        if (is_end && !is_skipping_line) {
+                            Add_Query(Parse_Pitch_Set(begin, end));
+                            parsed_size = input_size;
+                        } else if (parsed_size == 0 && input_size == input.size()) {
+                            if (!is_skipping_line) {
+                                Add_Query(0);
+                                is_skipping_line = true;
+                            }
+                            parsed_size = input_size;
+                        }
+                        break;
+                    }
+                }
+            }
+            std::memmove(input.data(), input.data() + parsed_size, input_size - parsed_size);
+            input_size -= parsed_size;
+
+            Answer_Batch();
+            if (is_end) {
+                break;
+            }
+        }
+
+        return is_good;
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    bool
+        pitch_set_server_t<CHROMATIC_NOTE_COUNT_p>::Serve_Socket(const char* path)
+    {
+#if defined(_WIN32)
+        static_cast<void>(path);
+
+        return false;
+#else
+        sockaddr_un address;
+        std::memset(&address, 0, sizeof(address));
+        address.sun_family = AF_UNIX;
+        if (std::strlen(path) >= sizeof(address.sun_path)) {
+            return false;
+        }
+        std::strcpy(address.sun_path, path);
+
+        // only a socket left behind by an earlier server is replaced. anything else at the path is left alone.
+        struct stat status;
+        if (lstat(path, &status) == 0) {
+            if (!S_ISSOCK(status.st_mode)) {
+                errno = EEXIST;
+                return false;
+            } else if (unlink(path) != 0) {
+                return false;
+            }
+        } else if (errno != ENOENT) {
+            return false;
+        }
+
+        const int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (listener < 0) {
+            return false;
+        }
+        if (bind(listener, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+            const int error = errno;
+            close(listener);
+            errno = error;
+            return false;
+        }
+
+        // each connection is served on its own thread until its client closes it, so that a client that stays connected
+        // without sending anything keeps no one else waiting. the threads of closed connections are joined as new ones come in.
+        struct connection_t
+        {
+            std::atomic<bool>   is_done = false;
+            std::jthread        thread;
+        };
+
+        std::list<connection_t> connections;
+        while (true) {
+            const int connection = accept(listener, nullptr, nullptr);
+            if (connection >= 0) {
+                connections.remove_if(
+                    [](const connection_t& connection) -> bool
+                    {
+                        return connection.is_done.load(std::memory_order_acquire);
+                    }
+                );
+
+#if defined(SO_NOSIGPIPE)
+                // where send has no MSG_NOSIGNAL, the socket itself is told not to raise SIGPIPE.
+                const int is_no_sigpipe = 1;
+                setsockopt(connection, SOL_SOCKET, SO_NOSIGPIPE, &is_no_sigpipe, sizeof(is_no_sigpipe));
+#endif
+                connection_t& served = connections.emplace_back();
+                served.thread = std::jthread(
+                    [this, connection, &served]() -> void
+                    {
+                        Serve(connection, connection);
+                        close(connection);
+                        served.is_done.store(true, std::memory_order_release);
+                    }
+                );
+            } else if (errno != EINTR) {
+                break;
+            }
+        }
+        const int error = errno;
+        close(listener);
+        connections.clear();
+        errno = error;
+
+        return false;
+#endif
+    }
+
+}
+
+namespace musical_calculator {
+
+    inline modulation_paths_t::modulation_paths_t(const index_t source_idx, const count_t node_count) :
+        source_idx(source_idx),
+        distances(node_count, UNREACHED_DISTANCE),
+        parents(node_count, NO_NODE)
+    {
+        assert(source_idx < node_count);
+    }
+
+    inline count_t
+        modulation_paths_t::Reached_Count()
+        noexcept
+    {
+        return this->distances.size() -
+            static_cast<count_t>(std::count(this->distances.begin(), this->distances.end(), UNREACHED_DISTANCE));
+    }
+
+    inline bool
+        modulation_paths_t::Is_Reached(const index_t node_idx)
+        noexcept
+    {
+        assert(node_idx < this->parents.size());
+
+        return this->parents[node_idx] != NO_NODE;
+    }
+
+    inline count_t
+        modulation_paths_t::Distance(const index_t node_idx)
+        noexcept
+    {
+        assert(Is_Reached(node_idx));
+
+        return this->distances[node_idx];
+    }
+
+    inline std::vector<index_t>
+        modulation_paths_t::Path(const index_t target_idx)
+    {
+        std::vector<index_t> path;
+        if (Is_Reached(target_idx)) {
+            path.reserve(Distance(target_idx) + 1);
+            for (index_t node_idx = target_idx; node_idx != this->source_idx; node_idx = this->parents[node_idx]) {
+                path.push_back(node_idx);
+            }
+            path.push_back(this->source_idx);
+            std::reverse(path.begin(), path.end());
+        }
+
+        return path;
+    }
+
+}
+
+namespace musical_calculator {
+
+    static_assert(CHROMATIC_MODE_COUNTS[MAX_CHROMATIC_NOTE_COUNT - 1] < modulation_paths_t::NO_NODE);
+
+    inline modulation_graph_t::modulation_graph_t(const mask_t* const           scales,
+                                                  const count_t                 scale_count,
+                                                  const count_t                 chromatic_note_count,
+                                                  const modulation_config_t&    config) :
+        modulation_graph_t(std::vector<mask_t>(scales, scales + scale_count), chromatic_note_count, config)
+    {
+    }
+
+    inline modulation_graph_t::modulation_graph_t(std::vector<mask_t>&&         scales,
+                                                  const count_t                 chromatic_note_count,
+                                                  const modulation_config_t&    config) :
+        chromatic_note_count(chromatic_note_count),
+        node(modulation_node_e::SCALES),
+        config(config),
+        scales(std::move(scales)),
+        tier_offsets(chromatic_note_count + 1, 0),
+        edge_offsets(),
+        edges()
+    {
+        assert(chromatic_note_count > 0);
+        assert(chromatic_note_count <= MAX_CHROMATIC_NOTE_COUNT);
+
+        // the scales are found by a binary search in their tier, and so they have to be in the order a chromatic gives them in.
+        // a chromatic's scales already are, and are only checked.
+        auto Scale_Precedes = [](const mask_t scale, const mask_t other_scale) -> bool
+        {
+            const count_t note_count = Mask_Note_Count(scale);
+            const count_t other_note_count = Mask_Note_Count(other_scale);
+            return note_count != other_note_count ? note_count < other_note_count : Mask_Precedes(scale, other_scale);
+        };
+        if (!std::is_sorted(this->scales.begin(), this->scales.end(), Scale_Precedes)) {
+            std::sort(this->scales.begin(), this->scales.end(), Scale_Precedes);
+        }
+        this->scales.erase(std::unique(this->scales.begin(), this->scales.end()), this->scales.end());
+
+        // the scales are in order of their note counts, and so each tier ends where the next begins.
+        for (index_t scale_idx = 0, scale_end = this->scales.size(); scale_idx < scale_end; scale_idx += 1) {
+            this->tier_offsets[Mask_Note_Count(this->scales[scale_idx])] = scale_idx + 1;
+        }
+        for (index_t tier_idx = 1, tier_end = this->tier_offsets.size(); tier_idx < tier_end; tier_idx += 1) {
+            this->tier_offsets[tier_idx] = std::max(this->tier_offsets[tier_idx], this->tier_offsets[tier_idx - 1]);
+        }
+
+        Build();
+    }
+
+    inline modulation_graph_t::modulation_graph_t(chromatic_engine_t& chromatic, const modulation_config_t& config) :
+        modulation_graph_t(chromatic.Scale_Masks(), chromatic.Chromatic_Note_Count(), config)
+    {
+    }
+
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    modulation_graph_t::modulation_graph_t(chromatic_t<CHROMATIC_NOTE_COUNT_p>& chromatic, const modulation_config_t& config) :
+        modulation_graph_t(chromatic.Scale_Masks(), CHROMATIC_NOTE_COUNT_p, config)
+    {
+    }
+
+    inline modulation_graph_t::modulation_graph_t(const count_t chromatic_note_count, const modulation_config_t& config) :
+        chromatic_note_count(chromatic_note_count),
+        node(modulation_node_e::MODES),
+        config(config),
+        scales(),
+        tier_offsets(chromatic_note_count + 1, CHROMATIC_MODE_COUNTS[chromatic_note_count - 1]),
+        edge_offsets(),
+        edges()
+    {
+        assert(chromatic_note_count > 0);
+        assert(chromatic_note_count <= MAX_CHROMATIC_NOTE_COUNT);
+
+        // each mode is found by its rank in its tier, which is offset by the tiers before it.
+        for (count_t note_count = 1; note_count <= chromatic_note_count; note_count += 1) {
+            this->tier_offsets[note_count - 1] = Tier_First_Mode_Index(note_count, chromatic_note_count);
+        }
+
+        Build();
+    }
+
+    inline count_t
+        modulation_graph_t::Modulate(const mask_t mask, mask_t* const results)
+        noexcept
+    {
+        assert(mask != 0);
+        assert((mask & ~Chromatic_Mask(this->chromatic_note_count)) == 0);
+
+        const count_t chromatic_note_count = this->chromatic_note_count;
+        const mask_t highest_note = mask_t(1) << (chromatic_note_count - 1);
+
+        // the root of a mode is never changed, which keeps it in the same key.
+        const mask_t changeable_notes = this->node == modulation_node_e::MODES ? mask & ~mask_t(1) : mask;
+
+        count_t result_count = 0;
+        if (this->config.has_added_notes) {
+            for (mask_t free_notes = Chromatic_Mask(chromatic_note_count) & ~mask; free_notes != 0; free_notes &= free_notes - 1) {
+                results[result_count++] = mask | (free_notes & (~free_notes + 1));
+            }
+        }
+        if (this->config.has_removed_notes) {
+            for (mask_t notes = changeable_notes; notes != 0; notes &= notes - 1) {
+                const mask_t removed = mask & ~(notes & (~notes + 1));
+                if (removed != 0) {
+                    results[result_count++] = removed;
+                }
+            }
+        }
+        if (this->config.has_moved_notes) {
+            // a step up from the highest note is the 1 of the next octave, and a step down from 1 is the highest note.
+            // the root of a mode never moves, and so no other note of a mode can step onto it.
+            for (mask_t notes = changeable_notes; notes != 0; notes &= notes - 1) {
+                const mask_t note = notes & (~notes + 1);
+                const mask_t note_above = note == highest_note ? mask_t(1) : note << 1;
+                const mask_t note_below = note == mask_t(1) ? highest_note : note >> 1;
+                if ((mask & note_above) == 0) {
+                    results[result_count++] = mask ^ note ^ note_above;
+                }
+                if ((mask & note_below) == 0 && note_below != note_above) {
+                    results[result_count++] = mask ^ note ^ note_below;
+                }
+            }
+        }
+        assert(result_count <= MAX_NEIGHBOUR_COUNT);
+
+        return result_count;
+    }
+
+    inline count_t
+        modulation_graph_t::Find_Neighbours(const mask_t mask, std::uint32_t* const results)
+        noexcept
+    {
+        mask_t pitch_sets[MAX_NEIGHBOUR_COUNT];
+        count_t result_count = Modulate(mask, pitch_sets);
+        for (index_t idx = 0; idx < result_count; idx += 1) {
+            results[idx] = static_cast<std::uint32_t>(Node_Index(pitch_sets[idx]));
+        }
+        std::sort(results, results + result_count);
+
+        // every change to a mode gives a different mode, but changes to a scale can give the same scale in different keys,
+        // and a moved note can even give back the scale itself. a scale that isn't in the graph has no node, which sorts last.
+        if (this->node == modulation_node_e::SCALES) {
+            result_count = std::lower_bound(results, results + result_count, modulation_paths_t::NO_NODE) - results;
+            result_count = std::unique(results, results + result_count) - results;
+            result_count = std::remove(results, results + result_count, static_cast<std::uint32_t>(Node_Index(mask))) - results;
+        }
+
+        return result_count;
+    }
+
+    inline void
+        modulation_graph_t::Build_Chunk(const index_t chunk_idx, const bool is_counting)
+        noexcept
+    {
+        const index_t first_node_idx = chunk_idx * BUILD_CHUNK_NODE_COUNT;
+        const index_t end_node_idx = std::min(first_node_idx + BUILD_CHUNK_NODE_COUNT, Node_Count());
+
+        // the modes of a chunk are stepped through rather than each unranked.
+        mask_t mask = Node_Mask(first_node_idx);
+        for (index_t node_idx = first_node_idx; node_idx < end_node_idx; node_idx += 1) {
+            // the neighbours are found in a buffer with room for every change, some of which can be dropped as repeats.
+            if (is_counting && this->node == modulation_node_e::MODES) {
+                mask_t pitch_sets[MAX_NEIGHBOUR_COUNT];
+                this->edge_offsets[node_idx + 1] = Modulate(mask, pitch_sets);
+            } else {
+                std::uint32_t neighbours[MAX_NEIGHBOUR_COUNT];
+                const count_t neighbour_count = Find_Neighbours(mask, neighbours);
+                if (is_counting) {
+                    this->edge_offsets[node_idx + 1] = neighbour_count;
+                } else {
+                    assert(neighbour_count == Neighbour_Count(node_idx));
+                    std::copy(neighbours, neighbours + neighbour_count, this->edges.data() + this->edge_offsets[node_idx]);
+                }
+            }
+
+            if (node_idx + 1 == end_node_idx) {
+                break;
+            } else if (this->node == modulation_node_e::MODES) {
+                // the last mode of a tier is followed by the first of the next, whose notes are a run up from 1.
+                const mask_t next_mask = Next_Mask(mask, this->chromatic_note_count);
+                mask = next_mask != 0 ? next_mask : Chromatic_Mask(Mask_Note_Count(mask) + 1);
+            } else {
+                mask = this->scales[node_idx + 1];
+            }
+        }
+    }
+
+    inline void
+        modulation_graph_t::Build()
+    {
+        // like building a chromatic, a small graph is built on this thread alone.
+        thread_pool_t serial_thread_pool(1);
+        thread_pool_t& chosen_thread_pool = thread_pool_t::Choose(Node_Count(), this->config.thread_pool, serial_thread_pool);
+
+        // the neighbours of a mode are counted without finding them, because no two changes give the same mode.
+        const count_t chunk_count = (Node_Count() + BUILD_CHUNK_NODE_COUNT - 1) / BUILD_CHUNK_NODE_COUNT;
+        this->edge_offsets.assign(Node_Count() + 1, 0);
+        chosen_thread_pool.Run_Tasks(
+            chunk_count,
+            [this](const index_t chunk_idx) -> void
+            {
+                Build_Chunk(chunk_idx, true);
+            }
+        );
+
+        std::partial_sum(this->edge_offsets.begin(), this->edge_offsets.end(), this->edge_offsets.begin());
+        this->edges.resize(this->edge_offsets.back());
+        chosen_thread_pool.Run_Tasks(
+            chunk_count,
+            [this](const index_t chunk_idx) -> void
+            {
+                Build_Chunk(chunk_idx, false);
+            }
+        );
+    }
+
+    inline count_t
+        modulation_graph_t::Node_Count()
+        noexcept
+    {
+        if (this->node == modulation_node_e::MODES) {
+            return CHROMATIC_MODE_COUNTS[this->chromatic_note_count - 1];
+        } else {
+            return this->scales.size();
+        }
+    }
+
+    inline count_t
+        modulation_graph_t::Edge_Count()
+        noexcept
+    {
+        return this->edges.size();
+    }
+
+    inline mask_t
+        modulation_graph_t::Node_Mask(const index_t node_idx)
+        noexcept
+    {
+        assert(node_idx < Node_Count());
+
+        if (this->node == modulation_node_e::MODES) {
+            return Mode_Index_Mask(node_idx, this->chromatic_note_count);
+        } else {
+            return this->scales[node_idx];
+        }
+    }
+
+    inline index_t
+        modulation_graph_t::Node_Index(const mask_t pitch_set_mask)
+        noexcept
+    {
+        assert(pitch_set_mask != 0);
+        assert((pitch_set_mask & ~Chromatic_Mask(this->chromatic_note_count)) == 0);
+
+        // a pitch set is transposed down to start on 1, which makes it a mode.
+        const mask_t mode = pitch_set_mask >> std::countr_zero(pitch_set_mask);
+        if (this->node == modulation_node_e::MODES) {
+            return this->tier_offsets[Mask_Note_Count(mode) - 1] + Rank_Mask(mode, this->chromatic_note_count);
+        } else {
+            const mask_t scale = Scale_Mask(mode, this->chromatic_note_count);
+            const count_t scale_note_count = Mask_Note_Count(scale);
+            const mask_t* const first = this->scales.data() + this->tier_offsets[scale_note_count - 1];
+            const mask_t* const last = this->scales.data() + this->tier_offsets[scale_note_count];
+            const mask_t* const found = std::lower_bound(first, last, scale, Mask_Precedes);
+            if (found == last || *found != scale) {
+                return modulation_paths_t::NO_NODE;
+            }
+
+            return found - this->scales.data();
+        }
+    }
+
+    inline count_t
+        modulation_graph_t::Neighbour_Count(const index_t node_idx)
+        noexcept
+    {
+        assert(node_idx < Node_Count());
+
+        return this->edge_offsets[node_idx + 1] - this->edge_offsets[node_idx];
+    }
+
+    inline const std::uint32_t*
+        modulation_graph_t::Neighbours(const index_t node_idx)
+        noexcept
+    {
+        assert(node_idx < Node_Count());
+
+        return this->edges.data() + this->edge_offsets[node_idx];
+    }
+
+    inline modulation_paths_t
+        modulation_graph_t::Search(const index_t source_idx, const index_t target_idx, thread_pool_t* const thread_pool)
+    {
+        assert(source_idx < Node_Count());
+        assert(target_idx < Node_Count() || target_idx == modulation_paths_t::NO_NODE);
+
+        thread_pool_t serial_thread_pool(1);
+        thread_pool_t& chosen_thread_pool = thread_pool_t::Choose(Node_Count(), thread_pool, serial_thread_pool);
+
+        modulation_paths_t paths(source_idx, Node_Count());
+        paths.distances[source_idx] = 0;
+        paths.parents[source_idx] = static_cast<std::uint32_t>(source_idx);
+
+        // each chunk of the frontier keeps the nodes it claims in its own frontier, which is kept between steps.
+        std::vector<std::uint32_t> frontier(1, static_cast<std::uint32_t>(source_idx));
+        std::vector<std::vector<std::uint32_t>> chunk_frontiers;
+        for (count_t distance = 1;
+             !frontier.empty() && (target_idx == modulation_paths_t::NO_NODE || !paths.Is_Reached(target_idx));
+             distance += 1) {
+            assert(distance < modulation_paths_t::UNREACHED_DISTANCE);
+
+            const count_t chunk_count = (frontier.size() + SEARCH_CHUNK_NODE_COUNT - 1) / SEARCH_CHUNK_NODE_COUNT;
+            chunk_frontiers.resize(std::max(chunk_frontiers.size(), chunk_count));
+            chosen_thread_pool.Run_Tasks(
+                chunk_count,
+                [this, &paths, &frontier, &chunk_frontiers, distance](const index_t chunk_idx) -> void
+                {
+                    std::vector<std::uint32_t>& chunk_frontier = chunk_frontiers[chunk_idx];
+                    chunk_frontier.clear();
+                    for (index_t idx = chunk_idx * SEARCH_CHUNK_NODE_COUNT,
+                         end = std::min(idx + SEARCH_CHUNK_NODE_COUNT, frontier.size());
+                         idx < end;
+                         idx += 1) {
+                        const std::uint32_t node_idx = frontier[idx];
+                        const std::uint32_t* const neighbours = Neighbours(node_idx);
+                        for (index_t neighbour_idx = 0, neighbour_end = Neighbour_Count(node_idx);
+                             neighbour_idx < neighbour_end;
+                             neighbour_idx += 1) {
+                            // most neighbours were reached in an earlier step, and a plain load skips the swap for them.
+                            const std::uint32_t neighbour = neighbours[neighbour_idx];
+                            std::atomic_ref<std::uint32_t> parent(paths.parents[neighbour]);
+                            std::uint32_t no_parent = modulation_paths_t::NO_NODE;
+                            if (parent.load(std::memory_order_relaxed) == modulation_paths_t::NO_NODE &&
+                                parent.compare_exchange_strong(no_parent, node_idx, std::memory_order_relaxed)) {
+                                paths.distances[neighbour] = static_cast<std::uint8_t>(distance);
+                                chunk_frontier.push_back(neighbour);
+                            }
+                        }
+                    }
+                }
+            );
+
+            frontier.clear();
+            for (index_t chunk_idx = 0; chunk_idx < chunk_count; chunk_idx += 1) {
+                frontier.insert(frontier.end(), chunk_frontiers[chunk_idx].begin(), chunk_frontiers[chunk_idx].end());
+            }
         }
+
+        return paths;
+    }
+
+    inline std::vector<index_t>
+        modulation_graph_t::Shortest_Path(const index_t source_idx, const index_t target_idx, thread_pool_t* const thread_pool)
+    {
+        assert(target_idx < Node_Count());
+
+        return Search(source_idx, target_idx, thread_pool).Path(target_idx);
     }
 
 }
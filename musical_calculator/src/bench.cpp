@@ -0,0 +1,452 @@
+/*
+    Copyright 2022 r-neal-kelly
+*/
+
+#include <chrono>
+#include <cstring>
+
+#include "musical_calculator.h"
+
+#if defined(_WIN32)
+    #ifndef PSAPI_VERSION
+        #define PSAPI_VERSION 2
+    #endif
+    #include <psapi.h>
+#else
+    #include <sys/resource.h>
+#endif
+
+namespace musical_calculator {
+
+    /*
+        The benchmark times each stage of building a chromatic, one tier at a time where the stage works on tiers,
+        and prints one row per measurement so that runs can be compared with each other by any tool that reads tabs.
+
+        Each row has the stage, the engine that did it, the chromatic and tier (0 for the whole chromatic),
+        how many threads it ran on, how many modes or scales it went through, the best time of all repetitions,
+        the throughput, and the peak resident memory of the process so far.
+    */
+    struct bench_config_t
+    {
+        count_t min_chromatic_note_count    = 1;
+        count_t max_chromatic_note_count    = MAX_CHROMATIC_NOTE_COUNT;
+        count_t repetition_count            = 3;
+    };
+
+    using bench_clock_t = std::chrono::steady_clock;
+
+    // The peak resident memory of this process in megabytes.
+    double
+        Peak_Resident_MB()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS counters;
+        if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+            return static_cast<double>(counters.PeakWorkingSetSize) / (1024.0 * 1024.0);
+        } else {
+            return 0.0;
+        }
+#else
+        struct rusage usage;
+        getrusage(RUSAGE_SELF, &usage);
+    #if defined(__APPLE__)
+        return static_cast<double>(usage.ru_maxrss) / (1024.0 * 1024.0);
+    #else
+        return static_cast<double>(usage.ru_maxrss) / 1024.0;
+    #endif
+#endif
+    }
+
+    // Runs Function the given number of times and returns the best time in milliseconds.
+    // Function returns how many modes or scales it went through, which is kept in item_count.
+    template <typename function_t>
+    double
+        Time_Best(const count_t repetition_count, count_t& item_count, function_t&& Function)
+    {
+        double best_ms = 0.0;
+        for (index_t idx = 0, end = std::max(repetition_count, count_t(1)); idx < end; idx += 1) {
+            const bench_clock_t::time_point start = bench_clock_t::now();
+            item_count = Function();
+            const bench_clock_t::time_point stop = bench_clock_t::now();
+
+            const double ms = std::chrono::duration<double, std::milli>(stop - start).count();
+            if (idx == 0 || ms < best_ms) {
+                best_ms = ms;
+            }
+        }
+
+        return best_ms;
+    }
+
+    void
+        Print_Bench_Header()
+    {
+        std::cout << "stage\tengine\tchromatic\ttier\tthreads\titems\tms\titems_per_s\tpeak_rss_mb\n";
+    }
+
+    void
+        Print_Bench_Row(const char* stage,
+                        const char* engine,
+                        const count_t chromatic_note_count,
+                        const count_t tier_note_count,
+                        const count_t thread_count,
+                        const count_t item_count,
+                        const double ms)
+    {
+        const double items_per_s = ms > 0.0 ? static_cast<double>(item_count) / (ms / 1000.0) : 0.0;
+        std::cout <<
+            stage << '\t' <<
+            engine << '\t' <<
+            chromatic_note_count << '\t' <<
+            tier_note_count << '\t' <<
+            thread_count << '\t' <<
+            item_count << '\t' <<
+            ms << '\t' <<
+            static_cast<std::uint64_t>(items_per_s) << '\t' <<
+            Peak_Resident_MB() << std::endl;
+    }
+
+    // Times the stages that work on one tier at a time, each serially on this thread.
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        Bench_Tiers(const bench_config_t& config)
+    {
+        constexpr count_t N = CHROMATIC_NOTE_COUNT_p;
+
+        for (index_t tier_idx = 0; tier_idx < N; tier_idx += 1) {
+            const count_t mode_note_count = tier_idx + 1;
+            const count_t mode_count = CHROMATIC_TIER_MODE_COUNTS[N - 1][tier_idx];
+            count_t item_count = 0;
+            double ms = 0.0;
+
+            std::vector<note_t> notes(CHROMATIC_TIER_MODE_NOTE_COUNTS[N - 1][tier_idx]);
+            std::vector<mask_t> masks(mode_count);
+            mode_tier_t<N> notes_tier;
+            mode_tier_t<N> masks_tier;
+
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                notes_tier = mode_tier_t<N>(notes.data(), mode_note_count);
+                return mode_count;
+            });
+            Print_Bench_Row("generate_modes", "notes", N, mode_note_count, 1, item_count, ms);
+
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                masks_tier = mode_tier_t<N>(masks.data(), mode_note_count);
+                return mode_count;
+            });
+            Print_Bench_Row("generate_modes", "masks", N, mode_note_count, 1, item_count, ms);
+
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                mode_generator_t generator(N, mode_note_count);
+                count_t count = 0;
+                for (mask_t mask; generator.Next(mask);) {
+                    count += mask & 1;
+                }
+                return count;
+            });
+            Print_Bench_Row("generate_modes", "generator", N, mode_note_count, 1, item_count, ms);
+
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                scale_tier_t<N> scale_tier(notes_tier, mode_count, mode_note_count, scale_kernel_e::SCALE_MODES);
+                return mode_count;
+            });
+            Print_Bench_Row("filter_scales", "scale_modes", N, mode_note_count, 1, item_count, ms);
+
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                scale_tier_t<N> scale_tier(masks_tier, mode_count, mode_note_count, scale_kernel_e::ROTATIONS);
+                return mode_count;
+            });
+            Print_Bench_Row("filter_scales", "rotations", N, mode_note_count, 1, item_count, ms);
+
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                scale_tier_t<N> scale_tier(mode_note_count);
+                return scale_tier.Scale_Count();
+            });
+            Print_Bench_Row("filter_scales", "generator", N, mode_note_count, 1, item_count, ms);
+        }
+    }
+
+    // Times the stages that work on a whole chromatic, on the default pool.
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        Bench_Chromatic(const bench_config_t& config)
+    {
+        constexpr count_t N = CHROMATIC_NOTE_COUNT_p;
+
+        const count_t thread_count = thread_pool_t::Default().Worker_Count();
+        count_t item_count = 0;
+        double ms = 0.0;
+
+        ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+        {
+            chromatic_t<N> chromatic({ .storage = storage_e::NOTES });
+            return chromatic.Mode_Count();
+        });
+        Print_Bench_Row("build", "notes", N, 0, thread_count, item_count, ms);
+
+        ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+        {
+            chromatic_t<N> chromatic({ .storage = storage_e::MASKS });
+            return chromatic.Mode_Count();
+        });
+        Print_Bench_Row("build", "masks", N, 0, thread_count, item_count, ms);
+
+        ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+        {
+            chromatic_t<N> chromatic({ .storage = storage_e::MASKS, .scale_kernel = scale_kernel_e::REVOLVING_DOOR });
+            return chromatic.Mode_Count();
+        });
+        Print_Bench_Row("build", "revolving_door", N, 0, thread_count, item_count, ms);
+
+        ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+        {
+            chromatic_t<N> chromatic({ .has_mode_tiers = false });
+            return chromatic.Scale_Count();
+        });
+        Print_Bench_Row("build", "generator", N, 0, thread_count, item_count, ms);
+
+        ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+        {
+            chromatic_engine_t chromatic(N);
+            return chromatic.Mode_Count();
+        });
+        Print_Bench_Row("build", "engine", N, 0, thread_count, item_count, ms);
+
+        ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+        {
+            chromatic_engine_t chromatic(N, { .has_scale_memberships = true });
+            return chromatic.Mode_Count();
+        });
+        Print_Bench_Row("build", "engine_memberships", N, 0, thread_count, item_count, ms);
+
+        // the engine one note smaller is built beforehand, as it would already be in a sweep.
+        if constexpr (N > 1) {
+            chromatic_engine_t previous(N - 1);
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                chromatic_engine_t chromatic(N, chromatic_config_t(), &previous);
+                return chromatic.Mode_Count();
+            });
+            Print_Bench_Row("build", "engine_extended", N, 0, thread_count, item_count, ms);
+        }
+
+        {
+            chromatic_engine_t engine(N);
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                for (index_t tier_idx = 0; tier_idx < N; tier_idx += 1) {
+                    bracelet_tier_t bracelet_tier(engine.scales.data() + engine.scale_tier_offsets[tier_idx], engine.Tier_Scale_Count(tier_idx + 1), N);
+                }
+                return engine.Scale_Count();
+            });
+            Print_Bench_Row("group_bracelets", "engine", N, 0, 1, item_count, ms);
+
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                scale_analytics_t analytics(engine);
+                return analytics.Scale_Count();
+            });
+            Print_Bench_Row("analyze_scales", "engine", N, 0, thread_count, item_count, ms);
+
+            scale_analytics_t analytics(engine);
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                scale_index_t index(analytics);
+                return index.Scale_Count();
+            });
+            Print_Bench_Row("index_scales", "engine", N, 0, 1, item_count, ms);
+
+            // a typical query, for the scales with a fifth and no step larger than a minor third.
+            // its items are the scales it finds, as the query would otherwise be optimized away.
+            if constexpr (N > 7) {
+                scale_index_t index(analytics);
+                ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+                {
+                    return index.Query().With_Interval(7).With_Max_Step(3).Count();
+                });
+                Print_Bench_Row("query_scales", "engine", N, 0, 1, item_count, ms);
+            }
+
+            // the items of a graph are its edges, and of a search, the nodes it reaches.
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                modulation_graph_t graph(engine);
+                return graph.Edge_Count();
+            });
+            Print_Bench_Row("build_modulations", "scales", N, 0, thread_count, item_count, ms);
+
+            modulation_graph_t graph(engine);
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                return graph.Search(0).Reached_Count();
+            });
+            Print_Bench_Row("search_modulations", "scales", N, 0, thread_count, item_count, ms);
+        }
+
+        {
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                modulation_graph_t graph(N);
+                return graph.Edge_Count();
+            });
+            Print_Bench_Row("build_modulations", "modes", N, 0, thread_count, item_count, ms);
+
+            modulation_graph_t graph(N);
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                return graph.Search(0).Reached_Count();
+            });
+            Print_Bench_Row("search_modulations", "modes", N, 0, thread_count, item_count, ms);
+        }
+
+        chromatic_t<N> chromatic({ .storage = storage_e::MASKS });
+
+        ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+        {
+            return chromatic.Modes().size();
+        });
+        Print_Bench_Row("materialize_modes", "masks", N, 0, 1, item_count, ms);
+
+        ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+        {
+            return chromatic.Scales().size();
+        });
+        Print_Bench_Row("materialize_scales", "masks", N, 0, 1, item_count, ms);
+
+        // each level of simd this processor has classifies every mode of the chromatic.
+        {
+            std::vector<mask_t> masks(chromatic.Mode_Count());
+            std::vector<std::uint8_t> is_scales(chromatic.Mode_Count());
+            for (index_t idx = 0, end = masks.size(); idx < end; idx += 1) {
+                masks[idx] = chromatic.masks[idx];
+            }
+
+            const simd_e simds[] = { simd_e::SCALAR, simd_e::SSE2, simd_e::AVX2 };
+            const char* simd_names[] = { "scalar", "sse2", "avx2" };
+            for (index_t idx = 0; idx < 3 && simds[idx] <= Simd_Level(); idx += 1) {
+                ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+                {
+                    Classify_Scale_Masks(masks.data(), chromatic.Mode_Count(), N, is_scales.data(), simds[idx]);
+                    return masks.size();
+                });
+                Print_Bench_Row("classify_scales", simd_names[idx], N, 0, 1, item_count, ms);
+            }
+        }
+
+        if constexpr (N <= MAX_BAKED_CHROMATIC_NOTE_COUNT) {
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                return baked_chromatic_t<N>::Modes().size();
+            });
+            Print_Bench_Row("materialize_modes", "baked", N, 0, 1, item_count, ms);
+
+            ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                return baked_chromatic_t<N>::Scales().size();
+            });
+            Print_Bench_Row("materialize_scales", "baked", N, 0, 1, item_count, ms);
+        }
+
+        // printing goes to the null device, so that it measures formatting and writing without a disk in the way.
+#if defined(_WIN32)
+        std::FILE* null_file = std::fopen("NUL", "wb");
+#else
+        std::FILE* null_file = std::fopen("/dev/null", "wb");
+#endif
+        if (null_file) {
+            const format_e formats[] = { format_e::TEXT, format_e::MASKS };
+            const char* format_names[] = { "text", "masks" };
+            for (index_t idx = 0; idx < 2; idx += 1) {
+                ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+                {
+                    writer_t writer(null_file, formats[idx]);
+                    writer.Write_Modes(chromatic);
+                    writer.Flush();
+                    return chromatic.Mode_Count();
+                });
+                Print_Bench_Row("print_modes", format_names[idx], N, 0, thread_count, item_count, ms);
+            }
+            std::fclose(null_file);
+        }
+    }
+
+    // Times building the chromatic on pools of 1, 2, 4, and so on up to the number of cores.
+    template <count_t CHROMATIC_NOTE_COUNT_p>
+    void
+        Bench_Thread_Scaling(const bench_config_t& config)
+    {
+        constexpr count_t N = CHROMATIC_NOTE_COUNT_p;
+
+        const count_t core_count = std::max(std::thread::hardware_concurrency(), 1u);
+        for (count_t thread_count = 1;; thread_count = std::min(thread_count * 2, core_count)) {
+            thread_pool_t thread_pool(thread_count);
+            count_t item_count = 0;
+            const double ms = Time_Best(config.repetition_count, item_count, [&]() -> count_t
+            {
+                chromatic_t<N> chromatic({ .storage = storage_e::MASKS, .thread_pool = &thread_pool, .min_parallel_mode_count = 0 });
+                return chromatic.Mode_Count();
+            });
+            Print_Bench_Row("thread_scaling", "masks", N, 0, thread_count, item_count, ms);
+
+            if (thread_count == core_count) {
+                break;
+            }
+        }
+    }
+
+    template <std::size_t idx = 0>
+    void
+        Bench(const bench_config_t& config)
+    {
+        if constexpr (idx < MAX_CHROMATIC_NOTE_COUNT) {
+            constexpr count_t N = idx + 1;
+            if (N >= config.min_chromatic_note_count && N <= config.max_chromatic_note_count) {
+                Bench_Tiers<N>(config);
+                Bench_Chromatic<N>(config);
+                if (N == config.max_chromatic_note_count) {
+                    Bench_Thread_Scaling<N>(config);
+                }
+            }
+
+            Bench<idx + 1>(config);
+        }
+    }
+
+}
+
+// musical_calculator_bench [min_chromatic_note_count] [max_chromatic_note_count] [repetition_count]
+int
+    main(int argument_count, char** arguments)
+{
+    using namespace musical_calculator;
+
+    bench_config_t config;
+    if (argument_count > 1) {
+        config.min_chromatic_note_count = std::strtoull(arguments[1], nullptr, 10);
+        config.max_chromatic_note_count = config.min_chromatic_note_count;
+    }
+    if (argument_count > 2) {
+        config.max_chromatic_note_count = std::strtoull(arguments[2], nullptr, 10);
+    }
+    if (argument_count > 3) {
+        config.repetition_count = std::strtoull(arguments[3], nullptr, 10);
+    }
+
+    if (config.min_chromatic_note_count < 1 ||
+        config.max_chromatic_note_count > MAX_CHROMATIC_NOTE_COUNT ||
+        config.min_chromatic_note_count > config.max_chromatic_note_count) {
+        std::cerr << "chromatic_note_counts must be from 1 to " << MAX_CHROMATIC_NOTE_COUNT << std::endl;
+        return 1;
+    }
+
+    Print_Bench_Header();
+    Bench(config);
+
+    return 0;
+}
@@ -2,34 +2,374 @@
     Copyright 2022 r-neal-kelly
 */
 
+#include <chrono>
+#include <cstring>
+
 #include "musical_calculator.h"
 
 namespace musical_calculator {
 
-    template <std::size_t idx = 0>
     void
         Print_Tests()
     {
-        if constexpr (idx < MAX_CHROMATIC_NOTE_COUNT) {
-            chromatic_t<idx + 1> chromatic;
+        // each chromatic is extended from the one before it, which is cheaper than building each from scratch.
+        chromatic_engine_t chromatic(1);
+        for (count_t chromatic_note_count = 1; chromatic_note_count <= MAX_CHROMATIC_NOTE_COUNT; chromatic_note_count += 1) {
+            if (chromatic_note_count > 1) {
+                chromatic = chromatic_engine_t(chromatic_note_count, chromatic_config_t(), &chromatic);
+            }
 
-            std::cout << "chromatic_note_count: " << idx + 1 << std::endl;
+            std::cout << "chromatic_note_count: " << chromatic_note_count << std::endl;
             std::cout << "chromatic_mode_count: " << chromatic.Mode_Count() << std::endl;
             //chromatic.Print_Modes();
             std::cout << "chromatic_scale_count: " << chromatic.Scale_Count() << std::endl;
             //chromatic.Print_Scales();
             std::cout << std::endl;
+        }
+    }
+
+    // Builds each chromatic with every scale kernel and with the scale generator, checks that they all find
+    // the same scales, and prints how long each took.
+    template <std::size_t idx = 0>
+    bool
+        Compare_Scale_Kernels()
+    {
+        if constexpr (idx < MAX_CHROMATIC_NOTE_COUNT) {
+            using clock_t = std::chrono::steady_clock;
+
+            auto Build = [](const chromatic_config_t& config, std::vector<mask_t>& results) -> double
+            {
+                const clock_t::time_point start = clock_t::now();
+                chromatic_t<idx + 1> chromatic(config);
+                const clock_t::time_point stop = clock_t::now();
+
+                std::vector<scale_t> scales = chromatic.Scales();
+                results.clear();
+                results.reserve(scales.size());
+                for (index_t scale_idx = 0, scale_end = scales.size(); scale_idx < scale_end; scale_idx += 1) {
+                    results.push_back(scales[scale_idx].Mask());
+                }
+
+                return std::chrono::duration<double, std::milli>(stop - start).count();
+            };
+
+            std::vector<mask_t> scale_modes_results;
+            std::vector<mask_t> rotations_results;
+            std::vector<mask_t> revolving_door_results;
+            std::vector<mask_t> generator_results;
+            const double scale_modes_time = Build({ .storage = storage_e::MASKS, .scale_kernel = scale_kernel_e::SCALE_MODES }, scale_modes_results);
+            const double rotations_time = Build({ .storage = storage_e::MASKS, .scale_kernel = scale_kernel_e::ROTATIONS }, rotations_results);
+            const double revolving_door_time = Build({ .storage = storage_e::MASKS, .scale_kernel = scale_kernel_e::REVOLVING_DOOR }, revolving_door_results);
+            const double generator_time = Build({ .has_mode_tiers = false }, generator_results);
+            const bool is_match =
+                scale_modes_results == rotations_results &&
+                rotations_results == revolving_door_results &&
+                rotations_results == generator_results;
+
+            std::cout << "chromatic_note_count: " << idx + 1 << std::endl;
+            std::cout << "chromatic_scale_count: " << rotations_results.size() << std::endl;
+            std::cout << "scale_modes_ms: " << scale_modes_time << std::endl;
+            std::cout << "rotations_ms: " << rotations_time << std::endl;
+            std::cout << "revolving_door_ms: " << revolving_door_time << std::endl;
+            std::cout << "generator_ms: " << generator_time << std::endl;
+            std::cout << "kernels_match: " << (is_match ? "true" : "false") << std::endl;
+            std::cout << std::endl;
+
+            return Compare_Scale_Kernels<idx + 1>() && is_match;
+        } else {
+            return true;
+        }
+    }
+
+    // Writes every mode or every scale of a chromatic to stdout in the given format.
+    bool
+        Write(const count_t chromatic_note_count, const bool is_scales, const format_e format)
+    {
+        if (chromatic_note_count < 1 || chromatic_note_count > MAX_CHROMATIC_NOTE_COUNT) {
+            std::cerr << "chromatic_note_count must be from 1 to " << MAX_CHROMATIC_NOTE_COUNT << std::endl;
+            return false;
+        }
+
+        chromatic_engine_t chromatic(chromatic_note_count, { .has_mode_tiers = !is_scales });
+        writer_t writer(stdout, format);
+        if (is_scales) {
+            writer.Write_Scales(chromatic);
+        } else {
+            writer.Write_Modes(chromatic);
+        }
+
+        return writer.Flush();
+    }
+
+    // Prints the mode and scale counts of a chromatic of any size up to MAX_COUNTED_CHROMATIC_NOTE_COUNT, without generating it.
+    bool
+        Print_Counts(const count_t chromatic_note_count)
+    {
+        if (chromatic_note_count < 1 || chromatic_note_count > MAX_COUNTED_CHROMATIC_NOTE_COUNT) {
+            std::cerr << "chromatic_note_count must be from 1 to " << MAX_COUNTED_CHROMATIC_NOTE_COUNT << std::endl;
+            return false;
+        }
+
+        std::cout << "chromatic_note_count: " << chromatic_note_count << std::endl;
+        std::cout << "chromatic_mode_count: " << Count_Modes(chromatic_note_count).String() << std::endl;
+        std::cout << "chromatic_scale_count: " << Count_Scales(chromatic_note_count).String() << std::endl;
+        for (count_t note_count = 1; note_count <= chromatic_note_count; note_count += 1) {
+            std::cout << "tier " << note_count << ": " <<
+                Count_Tier_Modes(chromatic_note_count, note_count).String() << " modes, " <<
+                Count_Tier_Scales(chromatic_note_count, note_count).String() << " scales" << std::endl;
+        }
+
+        return true;
+    }
+
+    // Computes one shard of a chromatic's modes and writes its scales to a shard file, to be merged with the others later.
+    bool
+        Write_Shard(const count_t chromatic_note_count, const index_t shard_idx, const count_t shard_count, const char* path)
+    {
+        if (chromatic_note_count < 1 || chromatic_note_count > MAX_CHROMATIC_NOTE_COUNT) {
+            std::cerr << "chromatic_note_count must be from 1 to " << MAX_CHROMATIC_NOTE_COUNT << std::endl;
+            return false;
+        }
+        if (shard_count < 1 || shard_idx >= shard_count) {
+            std::cerr << "shard_idx must be less than shard_count" << std::endl;
+            return false;
+        }
+
+        const index_t first_mode_idx = shard_t::Shard_First_Mode_Index(chromatic_note_count, shard_idx, shard_count);
+        const index_t end_mode_idx = shard_t::Shard_First_Mode_Index(chromatic_note_count, shard_idx + 1, shard_count);
+        shard_t shard(chromatic_note_count, first_mode_idx, end_mode_idx - first_mode_idx);
+        if (!shard.Write(path)) {
+            std::cerr << "could not write " << path << std::endl;
+            return false;
+        }
+
+        std::cout << "shard " << shard_idx << " of " << shard_count << ": modes " << first_mode_idx << " to " << end_mode_idx <<
+            ", " << shard.Scale_Count() << " scales" << std::endl;
 
-            Print_Tests<idx + 1>();
+        return true;
+    }
+
+    // Merges shard files, in any order, into one that covers the whole chromatic, and prints its counts.
+    bool
+        Merge_Shards(const char* path, const char* const* shard_paths, const count_t shard_path_count)
+    {
+        std::vector<shard_t> shards(shard_path_count);
+        for (index_t idx = 0, end = shard_path_count; idx < end; idx += 1) {
+            if (!shards[idx].Read(shard_paths[idx])) {
+                std::cerr << "could not read " << shard_paths[idx] << std::endl;
+                return false;
+            }
+        }
+        std::sort(
+            shards.begin(),
+            shards.end(),
+            [](const shard_t& a, const shard_t& b) -> bool
+            {
+                return a.First_Mode_Index() < b.First_Mode_Index();
+            }
+        );
+
+        shard_t merged;
+        for (index_t idx = 0, end = shards.size(); idx < end; idx += 1) {
+            if (!merged.Merge(shards[idx])) {
+                std::cerr << "shards must be of the same chromatic, with no modes missing or repeated" << std::endl;
+                return false;
+            }
+        }
+        if (!merged.Is_Complete()) {
+            std::cerr << "shards do not cover every mode of the chromatic" << std::endl;
+            return false;
+        }
+        if (!merged.Write(path)) {
+            std::cerr << "could not write " << path << std::endl;
+            return false;
+        }
+
+        std::cout << "chromatic_note_count: " << merged.Chromatic_Note_Count() << std::endl;
+        std::cout << "chromatic_mode_count: " << merged.Mode_Count() << std::endl;
+        std::cout << "chromatic_scale_count: " << merged.Scale_Count() << std::endl;
+        for (count_t note_count = 1; note_count <= merged.Chromatic_Note_Count(); note_count += 1) {
+            std::cout << "tier " << note_count << ": " << merged.Tier_Scale_Count(note_count) << " scales" << std::endl;
+        }
+
+        return true;
+    }
+
+    // Writes a snapshot of a chromatic's scales and its scale lookup, which serve can load in place of building them.
+    template <std::size_t idx = 0>
+    bool
+        Write_Snapshot(const count_t chromatic_note_count, const char* path)
+    {
+        if constexpr (idx < MAX_CHROMATIC_NOTE_COUNT) {
+            if (chromatic_note_count != idx + 1) {
+                return Write_Snapshot<idx + 1>(chromatic_note_count, path);
+            }
+
+            chromatic_t<idx + 1> chromatic({ .has_mode_tiers = false });
+            scale_lookup_t<idx + 1> scale_lookup(chromatic);
+            if (!snapshot_t::Write(path, chromatic, &scale_lookup)) {
+                std::cerr << "could not write " << path << std::endl;
+                return false;
+            }
+
+            std::cout << "chromatic_note_count: " << chromatic.Chromatic_Note_Count() << std::endl;
+            std::cout << "chromatic_scale_count: " << chromatic.Scale_Count() << std::endl;
+
+            return true;
+        } else {
+            std::cerr << "chromatic_note_count must be from 1 to " << MAX_CHROMATIC_NOTE_COUNT << std::endl;
+            return false;
+        }
+    }
+
+    // Prints a shortest way of changing from one pitch set to another, one note at a time, through the scales or the modes
+    // of a chromatic. Each pitch set is a string of notes, e.g. "1 5 8", and is taken as the scale or mode it transposes down to.
+    bool
+        Print_Modulation(const count_t chromatic_note_count, const modulation_node_e node, const char* from, const char* to)
+    {
+        if (chromatic_note_count < 1 || chromatic_note_count > MAX_CHROMATIC_NOTE_COUNT) {
+            std::cerr << "chromatic_note_count must be from 1 to " << MAX_CHROMATIC_NOTE_COUNT << std::endl;
+            return false;
+        }
+
+        const mask_t chromatic_mask = Chromatic_Mask(chromatic_note_count);
+        const mask_t from_mask = pitch_set_server_t<MAX_CHROMATIC_NOTE_COUNT>::Parse_Pitch_Set(from, from + std::strlen(from));
+        const mask_t to_mask = pitch_set_server_t<MAX_CHROMATIC_NOTE_COUNT>::Parse_Pitch_Set(to, to + std::strlen(to));
+        if (from_mask == 0 || to_mask == 0 || (from_mask & ~chromatic_mask) != 0 || (to_mask & ~chromatic_mask) != 0) {
+            std::cerr << "pitch sets must be notes from 1 to " << chromatic_note_count << ", e.g. \"1 5 8\"" << std::endl;
+            return false;
+        }
+
+        auto Print_Path = [from_mask, to_mask](modulation_graph_t& graph) -> bool
+        {
+            const std::vector<index_t> path = graph.Shortest_Path(graph.Node_Index(from_mask), graph.Node_Index(to_mask));
+            if (path.empty()) {
+                std::cerr << "there is no modulation between them" << std::endl;
+                return false;
+            }
+
+            char line[writer_t::MAX_FORMATTED_MODE_SIZE];
+            for (index_t node_idx : path) {
+                std::cout.write(line, writer_t::Format_Mask(line, graph.Node_Mask(node_idx), format_e::TEXT) - line);
+            }
+
+            return true;
+        };
+
+        if (node == modulation_node_e::SCALES) {
+            chromatic_engine_t chromatic(chromatic_note_count);
+            modulation_graph_t graph(chromatic);
+            return Print_Path(graph);
+        } else {
+            modulation_graph_t graph(chromatic_note_count);
+            return Print_Path(graph);
+        }
+    }
+
+    // Answers pitch sets from stdin, or from each connection to a Unix socket, until the input ends. The chromatic
+    // and its scale lookup are built once beforehand, or loaded from a snapshot when one is given instead of a note count.
+    template <std::size_t idx = 0>
+    bool
+        Serve(const count_t chromatic_note_count, const snapshot_t* snapshot, const format_e format, const char* socket_path)
+    {
+        if constexpr (idx < MAX_CHROMATIC_NOTE_COUNT) {
+            if (chromatic_note_count != idx + 1) {
+                return Serve<idx + 1>(chromatic_note_count, snapshot, format, socket_path);
+            }
+
+            auto Serve_Chromatic = [format, socket_path](chromatic_t<idx + 1>& chromatic, scale_lookup_t<idx + 1>& scale_lookup) -> bool
+            {
+                pitch_set_server_t<idx + 1> server(chromatic, scale_lookup, format);
+                if (!socket_path) {
+                    return server.Serve(0, 1);
+                } else if (!server.Serve_Socket(socket_path)) {
+                    std::cerr << "could not serve on " << socket_path << ": " << std::strerror(errno) << std::endl;
+                    return false;
+                } else {
+                    return true;
+                }
+            };
+
+            if (snapshot) {
+                chromatic_t<idx + 1> chromatic(*snapshot);
+                if (snapshot->Has_Scale_Lookup()) {
+                    scale_lookup_t<idx + 1> scale_lookup(*snapshot);
+                    return Serve_Chromatic(chromatic, scale_lookup);
+                } else {
+                    scale_lookup_t<idx + 1> scale_lookup(chromatic);
+                    return Serve_Chromatic(chromatic, scale_lookup);
+                }
+            } else {
+                chromatic_t<idx + 1> chromatic({ .has_mode_tiers = false });
+                scale_lookup_t<idx + 1> scale_lookup(chromatic);
+                return Serve_Chromatic(chromatic, scale_lookup);
+            }
+        } else {
+            std::cerr << "chromatic_note_count must be from 1 to " << MAX_CHROMATIC_NOTE_COUNT << std::endl;
+            return false;
         }
     }
 
 }
 
 int
-    main(void)
+    main(int argument_count, char** arguments)
 {
-    musical_calculator::Print_Tests();
+    if (argument_count > 1 && std::strcmp(arguments[1], "compare_kernels") == 0) {
+        return musical_calculator::Compare_Scale_Kernels() ? 0 : 1;
+    } else if (argument_count > 2 && std::strcmp(arguments[1], "count") == 0) {
+        return musical_calculator::Print_Counts(std::strtoull(arguments[2], nullptr, 10)) ? 0 : 1;
+    } else if (argument_count > 5 && std::strcmp(arguments[1], "shard") == 0) {
+        // shard <chromatic_note_count> <shard_idx> <shard_count> <shard_path>
+        return musical_calculator::Write_Shard(
+            std::strtoull(arguments[2], nullptr, 10),
+            std::strtoull(arguments[3], nullptr, 10),
+            std::strtoull(arguments[4], nullptr, 10),
+            arguments[5]) ? 0 : 1;
+    } else if (argument_count > 3 && std::strcmp(arguments[1], "merge") == 0) {
+        // merge <merged_path> <shard_path>...
+        return musical_calculator::Merge_Shards(arguments[2], arguments + 3, argument_count - 3) ? 0 : 1;
+    } else if (argument_count > 3 && std::strcmp(arguments[1], "snapshot") == 0) {
+        // snapshot <chromatic_note_count> <snapshot_path>
+        return musical_calculator::Write_Snapshot(std::strtoull(arguments[2], nullptr, 10), arguments[3]) ? 0 : 1;
+    } else if (argument_count > 2 && std::strcmp(arguments[1], "serve") == 0) {
+        // serve <chromatic_note_count|snapshot_path> [text|masks] [socket_path]
+        char* number_end = nullptr;
+        const musical_calculator::count_t chromatic_note_count = std::strtoull(arguments[2], &number_end, 10);
+        musical_calculator::snapshot_t snapshot;
+        if (*number_end != '\0' && !snapshot.Open(arguments[2])) {
+            std::cerr << "could not open " << arguments[2] << std::endl;
+            return 1;
+        }
+        return musical_calculator::Serve(
+            snapshot.Is_Open() ? snapshot.Chromatic_Note_Count() : chromatic_note_count,
+            snapshot.Is_Open() ? &snapshot : nullptr,
+            argument_count > 3 && std::strcmp(arguments[3], "masks") == 0 ?
+                musical_calculator::format_e::MASKS :
+                musical_calculator::format_e::TEXT,
+            argument_count > 4 ? arguments[4] : nullptr) ? 0 : 1;
+    } else if (argument_count > 5 && std::strcmp(arguments[1], "modulate") == 0) {
+        // modulate <chromatic_note_count> <scales|modes> <from_notes> <to_notes>
+        return musical_calculator::Print_Modulation(
+            std::strtoull(arguments[2], nullptr, 10),
+            std::strcmp(arguments[3], "modes") == 0 ?
+                musical_calculator::modulation_node_e::MODES :
+                musical_calculator::modulation_node_e::SCALES,
+            arguments[4],
+            arguments[5]) ? 0 : 1;
+    } else if (argument_count > 3 && std::strcmp(arguments[1], "write") == 0) {
+        // write <chromatic_note_count> <modes|scales> [text|csv|tsv|masks]
+        const char* format = argument_count > 4 ? arguments[4] : "text";
+        return musical_calculator::Write(
+            std::strtoull(arguments[2], nullptr, 10),
+            std::strcmp(arguments[3], "scales") == 0,
+            std::strcmp(format, "csv") == 0 ? musical_calculator::format_e::CSV :
+            std::strcmp(format, "tsv") == 0 ? musical_calculator::format_e::TSV :
+            std::strcmp(format, "masks") == 0 ? musical_calculator::format_e::MASKS :
+            musical_calculator::format_e::TEXT) ? 0 : 1;
+    } else {
+        musical_calculator::Print_Tests();
+    }
 
     return 0;
 }